@@ -31,3 +31,4 @@
 #include "Matrix_impl.hpp"
 
 #include "MatrixVectorOperations.hpp"
+#include "utility/half_float.hpp"
@@ -35,6 +35,29 @@
   #define CACHE_LINE 16
 #endif
 
+// size of a cache line in bytes, for the partition of parallel loops
+#ifndef CACHE_LINE_SIZE
+  #define CACHE_LINE_SIZE 64
+#endif
+
+// width of the SIMD registers in bytes
+#ifndef SIMD_BYTES
+  #if defined(__AVX512F__)
+    #define SIMD_BYTES 64
+  #elif defined(__AVX__)
+    #define SIMD_BYTES 32
+  #else
+    #define SIMD_BYTES 16
+  #endif
+#endif
+
+// if REPRODUCIBLE_SIMD == 1, the cpu dispatched kernels use packets of
+// SIMD_BYTES on all cpus, so that reductions give the same results.
+// Otherwise they use the native width of the instruction set.
+#ifndef REPRODUCIBLE_SIMD
+  #define REPRODUCIBLE_SIMD 0
+#endif
+
 // if FIXED_SIZE == 1 use static arrays
 #ifndef FIXED_SIZE
   #define FIXED_SIZE 1
@@ -66,13 +66,20 @@
 #ifdef NDEBUG
   #define MSG_DBG(text)
   #define TEST_EXIT_DBG(test) MSG_DBG
+  #define TEST_EXIT_DBG_CONSTEXPR(test) MSG_DBG
   #define DBG_VAR(var)
 #else
   #define MSG_DBG MSG
   #define TEST_EXIT_DBG(test) if (!(test)) ERROR_EXIT
+  #define TEST_EXIT_DBG_CONSTEXPR(test) if (!(test)) CONSTEXPR_ERROR_EXIT
   #define DBG_VAR(var) var
 #endif
 
+/// ERROR_EXIT in a lambda, that can be used in constexpr functions. A failed 
+/// test in a constant expression is a compile error, since the lambda is 
+/// not constexpr. Used by TEST_EXIT_DBG_CONSTEXPR.
+#define CONSTEXPR_ERROR_EXIT(text) [&]() ERROR_EXIT(text) ()
+
 /// prints a message, if min(Msg::msgInfo, info) >= noinfo
 #define INFO(info,noinfo) if (info >= noino) MSG
 
@@ -24,7 +24,6 @@
 
 #pragma once
 
-#include <algorithm>		// std::copy
 #include <utility>		// std::swap
 #include <initializer_list>	// std::initializer_list
 
@@ -68,7 +67,7 @@ namespace AMDiS {
   public:
     /// \brief Default constructor. 
     /// allocates memory for a matrix of size \p r x \p c
-    explicit MatrixBase(size_type r = 0, size_type c = 0)
+    explicit constexpr MatrixBase(size_type r = 0, size_type c = 0)
       : super(Size::eval(r) * Size::eval(c == 0 ? r : c)),
         _rows(Size::eval(r)),
         _cols(Size::eval(c == 0 ? r : c))
@@ -77,7 +76,7 @@ namespace AMDiS {
     /// \brief Constructor with initializer.
     /// allocates memory for a matrix of size \p r x \p c and sets all 
     /// entries to \p value0
-    explicit MatrixBase(size_type r, size_type c, value_type value0)
+    explicit constexpr MatrixBase(size_type r, size_type c, value_type value0)
       : super(Size::eval(r) * Size::eval(c)),
         _rows(Size::eval(r)),
         _cols(Size::eval(c))
@@ -86,33 +85,47 @@ namespace AMDiS {
     }
     
     /// Copy constructor
-    MatrixBase(self const& other)
+    constexpr MatrixBase(self const& other)
       : super(other._size),
 	_rows(other._rows),
 	_cols(other._cols)
     {
-      std::copy(other.begin(), other.end(), _elements);
+      for (size_type i = 0; i < _size; ++i)
+	_elements[i] = other._elements[i];
     }
     
-    /// \brief cConstructor based on an expression.
-    /// Use the assignment operator for expressions to copy values elementwise
+    /// \brief Constructor based on an expression.
+    /// Static matrices are initialized elementwise, also in constant 
+    /// expressions. Otherwise, the assignment operator is used.
     template <Expression Expr>
-    MatrixBase(Expr const& expr)
+    constexpr MatrixBase(Expr const& expr)
       : super(size(expr)),
 	_rows(num_rows(expr)),
 	_cols(num_cols(expr))
     {
-      this->operator=(expr);
+      this->construct(expr, bool_<(Mem::_SIZE > 0)>());
+    }
+    
+    /// constructor using nested initializer lists, given row by row
+    constexpr MatrixBase(std::initializer_list<std::initializer_list<value_type>> l)
+      : super(l.size() * (l.size() > 0 ? l.begin()->size() : 0)),
+	_rows(l.size()),
+	_cols(l.size() > 0 ? l.begin()->size() : 0)
+    {
+      size_type i = 0;
+      for (auto const& row : l) {
+	TEST_EXIT_DBG_CONSTEXPR( row.size() == _cols )("All rows must have the same length!\n");
+	for (value_type const& v : row)
+	  _elements[i++] = v;
+      }
     }
-
-    /// destructor
-    ~MatrixBase() { }
     
 #ifndef _MSC_VER // bug in MSVC <= 2013
     /// copy assignment operator
-    self& operator=(self const& other)
+    constexpr self& operator=(self const& other)
     {
-      std::copy(other.begin(), other.end(), _elements);
+      for (size_type i = 0; i < _size; ++i)
+	_elements[i] = other._elements[i];
       return *this;
     }
 #endif
@@ -148,25 +161,25 @@ namespace AMDiS {
   // ----- element access functions  -------------------------------------------
   public:   
     /// Access to i-th matrix row.
-    inline pointer operator[](size_type i) 
+    constexpr pointer operator[](size_type i) 
     {
       return _elements + _cols * i;
     }
 
     /// Access to i-th matrix row for constant matrices.
-    inline const_pointer operator[](size_type i) const 
+    constexpr const_pointer operator[](size_type i) const 
     {
       return _elements + _cols * i;
     }
     
     /// Access to the i-th vector element.
-    inline value_type& operator()(size_type i, size_type j) 
+    constexpr value_type& operator()(size_type i, size_type j) 
     {
       return _elements[i * _cols + j];
     }
     
     /// Access to the i-th vector element. (const variant)
-    inline const value_type& operator()(size_type i, size_type j) const 
+    constexpr const value_type& operator()(size_type i, size_type j) const 
     {
       return _elements[i * _cols + j];
     }
@@ -191,10 +204,10 @@ namespace AMDiS {
     }
     
     /// Return the number of \ref _rows
-    inline size_type getNumRows() const { return _rows; }
+    constexpr size_type getNumRows() const { return _rows; }
     
     /// Return the number of \ref _cols
-    inline size_type getNumCols() const { return _cols; }
+    constexpr size_type getNumCols() const { return _cols; }
     
 #if 1
     /// initialize the matrix as a diagonal matrix
@@ -215,21 +228,21 @@ namespace AMDiS {
   
   /// Size of MatrixBase
   template <class M, class S>
-  size_t size(MatrixBase<M,S> const& mat)
+  constexpr size_t size(MatrixBase<M,S> const& mat)
   {
     return mat.getSize();
   }
   
   /// number of rows of MatrixBase
   template <class M, class S>
-  size_t num_rows(MatrixBase<M,S> const& mat)
+  constexpr size_t num_rows(MatrixBase<M,S> const& mat)
   {
     return mat.getNumRows();
   }
   
   /// number of columns of MatrixBase
   template <class M, class S>
-  size_t num_cols(MatrixBase<M,S> const& mat)
+  constexpr size_t num_cols(MatrixBase<M,S> const& mat)
   {
     return mat.getNumCols();
   }
@@ -34,12 +34,15 @@
 #include "traits/concepts.hpp"
 #include "traits/size.hpp"
 #include "traits/base_expr.hpp"
+#include "traits/aliasing.hpp"
 
 #include "operations/meta.hpp" 
 #include "operations/assign.hpp"
+#include "operations/packet.hpp"
 
 namespace AMDiS 
 {
+  template <class Model, class Super> struct NoAliasProxy;
   
   /// Base class for matrix and vector types.
   /**
@@ -66,28 +69,27 @@ namespace AMDiS
   // ---------------------------------------------------------------------------
   protected:
     /// default constructor
-    explicit MatrixVectorBase(size_type s = 0)
+    explicit constexpr MatrixVectorBase(size_type s = 0)
       : super(s)
     { }
     
   public:  
-    /// assignment of an expression    
+    /// assignment of an expression. The new container can not alias 
+    /// the expression, thus no test for aliasing is performed.
     template <Expression Expr>
-    explicit MatrixVectorBase(Expr const& expr)
+    explicit constexpr MatrixVectorBase(Expr const& expr)
       : super(size(expr))
     {
-      this->operator=(expr);
+      construct(expr, bool_<(Super::_SIZE > 0)>());
     }
-  
-    /// destructor
-    ~MatrixVectorBase() { }
     
     /// fill vector with scalar value
     template <class S>
       requires concepts::Convertible<S, value_type>
-    void set(S const& value) 
+    constexpr void set(S const& value) 
     {
-      std::fill(_elements, _elements + _size, value);
+      for (size_type i = 0; i < _size; ++i)
+	_elements[i] = value;
     }
     
     /// fill vector with values from pointer. No check of length is performed!
@@ -97,10 +99,18 @@ namespace AMDiS
     }
 
     /// Access to the i-th data element.
-    inline value_type& operator()(size_type i) { return _elements[i]; }
+    constexpr value_type& operator()(size_type i) { return _elements[i]; }
     
     /// Access to the i-th data element. (const variant)
-    inline const value_type& operator()(size_type i) const { return _elements[i]; }
+    constexpr const value_type& operator()(size_type i) const { return _elements[i]; }
+    
+    /// Access to the data elements [i, i+W) as SIMD packet.
+    template <int Bytes = SIMD_BYTES>
+    inline simd::Packet<value_type, Bytes> packet(size_type i) const
+      requires (simd::packet_traits<value_type>::size > 1)
+    { 
+      return simd::load<Bytes>(_elements + i);
+    }
     
     /// Returns pointer to the first vector element.
     inline iterator begin() { return _elements; }
@@ -186,16 +196,83 @@ namespace AMDiS
     }
     
   // ---------------------------------------------------------------------------
+  protected:
+    /// initialization of static containers by an elementwise loop, that can 
+    /// be evaluated in constant expressions.
+    template <class Expr>
+    constexpr void construct(Expr const& expr, true_)
+    {
+      for (size_type i = 0; i < Super::_SIZE; ++i)
+	_elements[i] = expr(i);
+    }
+    
+    /// initialization by the (runtime) assignment of expressions
+    template <class Expr>
+    void construct(Expr const& expr, false_)
+    {
+      noalias(*this) = expr;
+    }
+    
+    /// self-evaluating expressions are always assigned at runtime
+    template <class Expr>
+      requires requires(Expr const& e, Model& m) { e.assign_to(m, mtl::assign::assign_sum()); }
+    void construct(Expr const& expr, true_)
+    {
+      noalias(*this) = expr;
+    }
+    
   private:
+    template <class, class> friend struct NoAliasProxy;
     
-    /// basic assignment for compound operators given by the Assigner
+    /// basic assignment for compound operators given by the Assigner. 
+    /// Expressions that are not elementwise are tested for aliasing.
+    template <class Expr, class Assigner>
+    void assign(Expr const& expr, Assigner assigner)
+    {
+      TEST_EXIT_DBG( _size == size(expr) )("Sizes do not match!\n");
+      assign(expr, assigner, bool_<traits::alias_safe<Expr>::value>());
+    }
+    
+    /// assignment of expressions that evaluate themselves as a whole, e.g.
+    /// the matrix-matrix product using blocked kernels. Those kernels 
+    /// use a temporary for the result, so aliasing is not an issue.
     template <class Expr, class Assigner>
+      requires requires(Expr const& e, Model& m, Assigner a) { e.assign_to(m, a); }
     void assign(Expr const& expr, Assigner assigner)
     {
       TEST_EXIT_DBG( _size == size(expr) )("Sizes do not match!\n");
+      expr.assign_to(static_cast<Model&>(*this), assigner);
+    }
+    
+    /// assignment without test for aliasing
+    template <class Expr, class Assigner>
+    void assign(Expr const& expr, Assigner assigner, true_)
+    {
       super::assign_aux(static_cast<Model&>(*this), expr, assigner);
     }
     
+    /// assignment without test for aliasing (self-evaluating expressions)
+    template <class Expr, class Assigner>
+      requires requires(Expr const& e, Model& m, Assigner a) { e.assign_to(m, a); }
+    void assign(Expr const& expr, Assigner assigner, true_)
+    {
+      expr.assign_to(static_cast<Model&>(*this), assigner);
+    }
+    
+    /// assignment of an expression that might read from this container:
+    /// evaluate through a temporary only if the memory is really shared.
+    /// For static sizes the temporary is allocated on the stack.
+    template <class Expr, class Assigner>
+    void assign(Expr const& expr, Assigner assigner, false_)
+    {
+      if (aliases(expr, _elements, _elements + _size)) {
+	Model tmp(expr);
+	assign(tmp, assigner, true_());
+      } else {
+	assign(expr, assigner, true_());
+      }
+    }
+    
     /// basic assignment for compound operators given by the Assigner
     template <class Functor>
     inline void for_each(Functor f)
@@ -205,6 +282,72 @@ namespace AMDiS
   };
   
   
+  // ===========================================================================
+  
+  /// Proxy returned by \ref noalias, that assigns expressions without 
+  /// testing for aliasing.
+  template <class Model, class Super>
+  struct NoAliasProxy
+  {
+    typedef MatrixVectorBase<Model, Super> target_type;
+    
+    explicit NoAliasProxy(target_type& t) : target(t) {}
+    
+    /// assignment of an expression
+    template <Expression Expr>
+    Model& operator=(Expr const& expr)
+    {
+      return assign(expr, mtl::assign::assign_sum());
+    }
+    
+    /// compound plus-assignment of an expression
+    template <Expression Expr>
+    Model& operator+=(Expr const& expr)
+    {
+      return assign(expr, mtl::assign::plus_sum());
+    }
+    
+    /// compound minus-assignment of an expression
+    template <Expression Expr>
+    Model& operator-=(Expr const& expr)
+    {
+      return assign(expr, mtl::assign::minus_sum());
+    }
+    
+    /// compound times-assignment of an expression
+    template <Expression Expr>
+    Model& operator*=(Expr const& expr)
+    {
+      return assign(expr, mtl::assign::times_sum());
+    }
+    
+    /// compound divides-assignment of an expression
+    template <Expression Expr>
+    Model& operator/=(Expr const& expr)
+    {
+      return assign(expr, mtl::assign::divide_sum());
+    }
+    
+  private:
+    template <class Expr, class Assigner>
+    Model& assign(Expr const& expr, Assigner assigner)
+    {
+      TEST_EXIT_DBG( target.getSize() == size(expr) )("Sizes do not match!\n");
+      target.assign(expr, assigner, true_());
+      return static_cast<Model&>(target);
+    }
+    
+    target_type& target;
+  };
+  
+  /// \brief Assignment without test for aliasing: noalias(v) = A*w.
+  /// The user guarantees that \p target is not read by the expression.
+  template <class Model, class Super>
+  NoAliasProxy<Model, Super> noalias(MatrixVectorBase<Model, Super>& target)
+  {
+    return NoAliasProxy<Model, Super>(target);
+  }
+  
   // ===========================================================================
   
   struct DefaultSizePolicy
@@ -27,9 +27,14 @@
 #include "expressions/all_expr.hpp"
 
 #include "traits/concepts.hpp"
+#include "traits/tag.hpp"
 #include "operations/functors.hpp"
+#include "operations/simd_math.hpp"
 #include "operations/reduction_functors.hpp"
-#include <boost/numeric/mtl/operation/sfunctor.hpp>
+#include "operations/reduce_all.hpp"
+#include "operations/scatter.hpp"
+#include "operations/inverse.hpp"
+#include "operations/lu.hpp"
 
 namespace AMDiS 
 {
@@ -40,7 +45,7 @@ namespace AMDiS
   /// expression for V + W
   template <Expression E1, Expression E2>
     requires concepts::Addable<Value_type<E1>, Value_type<E2>>
-  auto operator+(E1 const& expr1, E2 const& expr2)
+  constexpr auto operator+(E1 const& expr1, E2 const& expr2)
   {
     return PlusExpr<E1, E2>(expr1, expr2);
   }
@@ -49,7 +54,7 @@ namespace AMDiS
   /// expression for V - W
   template <Expression E1, Expression E2>
     requires concepts::Subtractable<Value_type<E1>, Value_type<E2>>
-  auto operator-(E1 const& expr1, E2 const& expr2)
+  constexpr auto operator-(E1 const& expr1, E2 const& expr2)
   {
     return MinusExpr<E1, E2>(expr1, expr2);
   }
@@ -58,9 +63,9 @@ namespace AMDiS
   /// expression for -V
   template <Expression E>
     requires concepts::Negatable<Value_type<E>>
-  auto operator-(E const& expr)
+  constexpr auto operator-(E const& expr)
   {
-    using negate_op = ElementwiseUnaryExpr<E, mtl::sfunctor::negate<Value_type<E>> >;
+    using negate_op = ElementwiseUnaryExpr<E, functors::negate<Value_type<E>> >;
     return negate_op(expr);
   }
   
@@ -68,7 +73,7 @@ namespace AMDiS
   /// expression for V * scalar
   template <Arithmetic Value, Expression E>
     requires concepts::Multiplicable<Value_type<E>, Value>
-  auto operator*(E const& expr, Value scal)
+  constexpr auto operator*(E const& expr, Value scal)
   {
     return RightScaleExpr<Value, E>(scal, expr);
   }
@@ -77,7 +82,7 @@ namespace AMDiS
   /// expression for scalar * V
   template <Arithmetic Value, Expression E>
     requires concepts::Multiplicable<Value, Value_type<E>>
-  auto operator*(Value scal, E const& expr)
+  constexpr auto operator*(Value scal, E const& expr)
   {
     return LeftScaleExpr<Value, E>(scal, expr);
   }
@@ -86,25 +91,129 @@ namespace AMDiS
   /// expression for V / scalar
   template <Arithmetic Value, Expression E>
     requires concepts::Multiplicable<Value_type<E>, Value>
-  auto operator/(E const& expr, Value scal)
+  constexpr auto operator/(E const& expr, Value scal)
   {
     return RightDivideExpr<Value, E>(scal, expr);
   }
   
+  // ---------------------------------------------------------------------------
+  // Rewrite rules: the following overloads are more specialized than the 
+  // generic operators above. They fold scalar factors and map the BLAS-1 
+  // shapes a*x + y, a*x + b*y and x - a*y to fused expressions.
+  
+  /// \cond HIDDEN_SYMBOLS
+  // scaling of an expression by multiplication
+  template <class V, class E, bool l, class T1, class T2>
+  using TimesScaleExpr = ScaleExpr<V, E, l, functors::times<T1, T2>>;
+  /// \endcond
+  
+  /// s * (t * V) => (s*t) * V
+  template <Arithmetic Value, class V, Expression E, bool l, class T1, class T2>
+    requires concepts::Multiplicable<Value, V>
+  constexpr auto operator*(Value scal, TimesScaleExpr<V, E, l, T1, T2> const& expr)
+  {
+    typedef traits::mult_type<Value, V> value_type;
+    return LeftScaleExpr<value_type, E>(scal * expr.get_value(), expr.get_first());
+  }
+  
+  
+  /// (V * t) * s => V * (t*s)
+  template <Arithmetic Value, class V, Expression E, bool l, class T1, class T2>
+    requires concepts::Multiplicable<V, Value>
+  constexpr auto operator*(TimesScaleExpr<V, E, l, T1, T2> const& expr, Value scal)
+  {
+    typedef traits::mult_type<V, Value> value_type;
+    return RightScaleExpr<value_type, E>(expr.get_value() * scal, expr.get_first());
+  }
+  
+  
+  /// -(-V) => V
+  template <Expression E, class T>
+  constexpr traits::store_type<E> operator-(ElementwiseUnaryExpr<E, functors::negate<T>> const& expr)
+  {
+    return expr.get_first();
+  }
+  
+  
+  /// -(s * V) => (-s) * V
+  template <class V, Expression E, bool l, class T1, class T2>
+    requires concepts::Negatable<V>
+  constexpr auto operator-(TimesScaleExpr<V, E, l, T1, T2> const& expr)
+  {
+    return LeftScaleExpr<V, E>(-expr.get_value(), expr.get_first());
+  }
+  
+  
+  /// a*X + Y => fused axpy
+  template <class V, Expression E1, bool l, class T1, class T2, Expression E2>
+    requires Axpby_exact<V, E1, E2>
+  constexpr auto operator+(TimesScaleExpr<V, E1, l, T1, T2> const& x, E2 const& y)
+  {
+    return AxpyExpr<V, E1, E2>(x.get_value(), x.get_first(), aux::unit_scale(), y);
+  }
+  
+  
+  /// X + a*Y => fused axpy
+  template <Expression E1, class V, Expression E2, bool l, class T1, class T2>
+    requires Axpby_exact<V, E2, E1>
+  constexpr auto operator+(E1 const& x, TimesScaleExpr<V, E2, l, T1, T2> const& y)
+  {
+    return AxpyExpr<V, E2, E1>(y.get_value(), y.get_first(), aux::unit_scale(), x);
+  }
+  
+  
+  /// a*X + b*Y => fused axpby
+  template <class V1, Expression E1, bool l1, class T1, class T2,
+	    class V2, Expression E2, bool l2, class S1, class S2>
+    requires Axpby_exact<V1, E1, E2> && Axpby_exact<V2, E2, E1>
+  constexpr auto operator+(TimesScaleExpr<V1, E1, l1, T1, T2> const& x, 
+		 TimesScaleExpr<V2, E2, l2, S1, S2> const& y)
+  {
+    return AxpbyExpr<V1, E1, V2, E2>(x.get_value(), x.get_first(), y.get_value(), y.get_first());
+  }
+  
+  
+  /// X - a*Y => fused axpy with factor -a
+  template <Expression E1, class V, Expression E2, bool l, class T1, class T2>
+    requires Axpby_exact<V, E2, E1> && concepts::Negatable<V>
+  constexpr auto operator-(E1 const& x, TimesScaleExpr<V, E2, l, T1, T2> const& y)
+  {
+    return AxpyExpr<V, E2, E1>(-y.get_value(), y.get_first(), aux::unit_scale(), x);
+  }
+  
+  
+  /// a*X - b*Y => fused axpby with factor -b
+  template <class V1, Expression E1, bool l1, class T1, class T2,
+	    class V2, Expression E2, bool l2, class S1, class S2>
+    requires Axpby_exact<V1, E1, E2> && Axpby_exact<V2, E2, E1> && concepts::Negatable<V2>
+  constexpr auto operator-(TimesScaleExpr<V1, E1, l1, T1, T2> const& x, 
+		 TimesScaleExpr<V2, E2, l2, S1, S2> const& y)
+  {
+    return AxpbyExpr<V1, E1, V2, E2>(x.get_value(), x.get_first(), -y.get_value(), y.get_first());
+  }
+  
   // ---------------------------------------------------------------------------
   // scalar product
   
   /// scalar product V*V
   template <VectorExpr E1, VectorExpr E2>
     requires concepts::Multiplicable<Value_type<E1>, Value_type<E2>>
-  auto dot(E1 const& expr1, E2 const& expr2)
+  constexpr auto dot(E1 const& expr1, E2 const& expr2)
   {
     return DotExpr<E1, E2>(expr1, expr2)();
   }
   
+  /// scalar product V*V of real vectors, with compensated summation
+  template <VectorExpr E1, VectorExpr E2>
+    requires concepts::Multiplicable<Value_type<E1>, Value_type<E2>>
+  constexpr auto dot(E1 const& expr1, E2 const& expr2, tag::compensated)
+  {
+    return CompensatedDotExpr<E1, E2>(expr1, expr2)();
+  }
+  
   /// expression for V * W (dot product)
   template <VectorExpr E1, VectorExpr E2>
-  auto operator*(E1 const& expr1, E2 const& expr2)
+  constexpr auto operator*(E1 const& expr1, E2 const& expr2)
   {
     return dot(expr1, expr2);
   }
@@ -122,6 +231,163 @@ namespace AMDiS
     return CrossExpr<E1, E2>(expr1, expr2);
   }
   
+  /// expression for the outer product v w^T (tensor product) as matrix
+  template <VectorExpr E1, VectorExpr E2>
+    requires concepts::Multiplicable<Value_type<E1>, Value_type<E2>>
+  constexpr auto outer(E1 const& expr1, E2 const& expr2)
+  {
+    return OuterExpr<E1, E2>(expr1, expr2);
+  }
+  
+  // Rewrite rules: scalar factors of an outer product are moved to one of the
+  // vectors, so that M += a*outer(v,w) is a single rank-1 update.
+  
+  /// s * outer(V, W) => outer(s * V, W)
+  template <Arithmetic Value, class V, class W>
+  constexpr auto operator*(Value scal, OuterExpr<V, W> const& expr)
+  {
+    return outer(scal * expr.get_first(), expr.get_second());
+  }
+  
+  /// outer(V, W) * s => outer(V, W * s)
+  template <Arithmetic Value, class V, class W>
+  constexpr auto operator*(OuterExpr<V, W> const& expr, Value scal)
+  {
+    return outer(expr.get_first(), expr.get_second() * scal);
+  }
+  
+  /// -outer(V, W) => outer(-V, W)
+  template <class V, class W>
+  constexpr auto operator-(OuterExpr<V, W> const& expr)
+  {
+    return outer(-expr.get_first(), expr.get_second());
+  }
+  
+  // ---------------------------------------------------------------------------
+  // elementwise math functions, vectorized for float and double
+  
+  /// expression for (exp(V_0), exp(V_1), ...)
+  template <Expression E>
+  constexpr auto exp(E const& expr)
+  {
+    return ElementwiseUnaryExpr<E, functors::exp<Value_type<E>> >(expr);
+  }
+  
+  /// expression for (log(V_0), log(V_1), ...)
+  template <Expression E>
+  constexpr auto log(E const& expr)
+  {
+    return ElementwiseUnaryExpr<E, functors::log<Value_type<E>> >(expr);
+  }
+  
+  /// expression for (sqrt(V_0), sqrt(V_1), ...)
+  template <Expression E>
+  constexpr auto sqrt(E const& expr)
+  {
+    return ElementwiseUnaryExpr<E, functors::sqrt<Value_type<E>> >(expr);
+  }
+  
+  /// expression for (V_0^p, V_1^p, ...), for V_i >= 0
+  template <Expression E, Arithmetic Value>
+  constexpr auto pow(E const& expr, Value p)
+  {
+    return ScaleExpr<Value, E, false, functors::power<Value_type<E>, Value> >(p, expr);
+  }
+  
+  // ---------------------------------------------------------------------------
+  // determinant and inverse of batches of small matrices, see det(A), inv(A)
+  
+  /// expression for (det(A_0), det(A_1), ...), for a vector of matrices A_i
+  template <VectorExpr E>
+    requires MatrixExpr<Value_type<E>>
+  constexpr auto det(E const& batch)
+  {
+    return ElementwiseUnaryExpr<E, functors::determinant<Value_type<E>> >(batch);
+  }
+  
+  /// expression for (A_0^(-1), A_1^(-1), ...), for a vector of matrices A_i
+  template <VectorExpr E>
+    requires MatrixExpr<Value_type<E>>
+  constexpr auto inv(E const& batch)
+  {
+    return ElementwiseUnaryExpr<E, functors::inverse<Value_type<E>> >(batch);
+  }
+  
+  // ---------------------------------------------------------------------------
+  // elementwise comparison and selection. The operators <, == and != compare 
+  // whole expressions, thus the elementwise comparisons are named functions. 
+  // One of the operands may be a scalar.
+  
+  /// mask expression for (A_0 < B_0, A_1 < B_1, ...)
+  template <class A, class B>
+    requires Elementwise_operands<A, B>
+  constexpr auto less(A const& a, B const& b)
+  {
+    return LessExpr<A, B>(a, b);
+  }
+  
+  /// mask expression for (A_0 <= B_0, A_1 <= B_1, ...)
+  template <class A, class B>
+    requires Elementwise_operands<A, B>
+  constexpr auto less_equal(A const& a, B const& b)
+  {
+    return LessEqualExpr<A, B>(a, b);
+  }
+  
+  /// mask expression for (A_0 > B_0, A_1 > B_1, ...)
+  template <class A, class B>
+    requires Elementwise_operands<A, B>
+  constexpr auto greater(A const& a, B const& b)
+  {
+    return GreaterExpr<A, B>(a, b);
+  }
+  
+  /// mask expression for (A_0 >= B_0, A_1 >= B_1, ...)
+  template <class A, class B>
+    requires Elementwise_operands<A, B>
+  constexpr auto greater_equal(A const& a, B const& b)
+  {
+    return GreaterEqualExpr<A, B>(a, b);
+  }
+  
+  /// mask expression for (A_0 == B_0, A_1 == B_1, ...)
+  template <class A, class B>
+    requires Elementwise_operands<A, B>
+  constexpr auto equal_to(A const& a, B const& b)
+  {
+    return EqualExpr<A, B>(a, b);
+  }
+  
+  /// mask expression for (A_0 != B_0, A_1 != B_1, ...)
+  template <class A, class B>
+    requires Elementwise_operands<A, B>
+  constexpr auto not_equal_to(A const& a, B const& b)
+  {
+    return NotEqualExpr<A, B>(a, b);
+  }
+  
+  /// expression for (M_0 ? A_0 : B_0, M_1 ? A_1 : B_1, ...), with a mask 
+  /// expression \p mask. The operands \p a and \p b may be scalars.
+  template <Expression M, class A, class B>
+    requires std::is_same<Value_type<M>, bool>::value && 
+	     (Expression<A> || Arithmetic<A>) && (Expression<B> || Arithmetic<B>)
+  constexpr auto where(M const& mask, A const& a, B const& b)
+  {
+    return WhereExpr<M, A, B>(mask, a, b);
+  }
+  
+  // ---------------------------------------------------------------------------
+  // indirect access
+  
+  /// \brief expression for the gather (global(idx(0)), global(idx(1)), ...)
+  /// of the elements of \p global at the positions given by \p idx.
+  template <VectorExpr G, VectorExpr I>
+    requires Integral<Value_type<I>>
+  constexpr auto indexed(G const& global, I const& idx)
+  {
+    return IndexedExpr<G, I>(global, idx);
+  }
+  
   // ---------------------------------------------------------------------------
   // reduction operations
   
@@ -139,6 +405,13 @@ namespace AMDiS
     return TwoNormExpr<E>(expr)();
   }
   
+  /// expression for two_norm(V) of a real vector, with compensated summation
+  template <VectorExpr E>
+  auto two_norm(E const& expr, tag::compensated)
+  {
+    return CompensatedTwoNormExpr<E>(expr)();
+  }
+  
   /// expression for two_norm(M)
   template <MatrixExpr E>
   auto frobenius_norm(E const& expr)
@@ -169,14 +442,14 @@ namespace AMDiS
   
   /// expression for max(V)
   template <Expression E>
-  auto max(E const& expr)
+  constexpr auto max(E const& expr)
   {
     return MaxExpr<E>(expr)();
   }
   
   /// expression for abs_max(V)
   template <Expression E>
-  auto abs_max(E const& expr)
+  constexpr auto abs_max(E const& expr)
   {
     return AbsMaxExpr<E>(expr)();
   }
@@ -197,14 +470,14 @@ namespace AMDiS
   
   /// expression for min(V)
   template <Expression E>
-  auto min(E const& expr)
+  constexpr auto min(E const& expr)
   {
     return MinExpr<E>(expr)();
   }
   
   /// expression for abs_min(V)
   template <Expression E>
-  auto abs_min(E const& expr)
+  constexpr auto abs_min(E const& expr)
   {
     return AbsMinExpr<E>(expr)();
   }
@@ -212,14 +485,22 @@ namespace AMDiS
   /// expression for sum(V)
   template <Expression E>
     requires concepts::Addable<Value_type<E>, Value_type<E>>
-  auto sum(E const& expr)
+  constexpr auto sum(E const& expr)
   {
     return SumExpr<E>(expr)();
   }
   
+  /// expression for sum(V) of a real expression, with compensated summation
+  template <Expression E>
+    requires concepts::Addable<Value_type<E>, Value_type<E>>
+  constexpr auto sum(E const& expr, tag::compensated)
+  {
+    return CompensatedSumExpr<E>(expr)();
+  }
+  
   /// expression for sum(V) = v0 + v1 + v2 + ...
   template <Expression E>
-  auto mean(E const& expr)
+  constexpr auto mean(E const& expr)
   {
     return sum(expr) / size(expr);
   }
@@ -227,11 +508,35 @@ namespace AMDiS
   /// expression for prod(V) = v0 * v1 * v2 * ...
   template <Expression E>
     requires concepts::Multiplicable<Value_type<E>, Value_type<E>>
-  auto prod(E const& expr)
+  constexpr auto prod(E const& expr)
   {
     return ProdExpr<E>(expr)();
   }
   
+  /// true, if at least one element of the mask expression is true
+  template <Expression E>
+    requires std::is_same<Value_type<E>, bool>::value
+  constexpr bool any(E const& expr)
+  {
+    return AnyExpr<E>(expr)();
+  }
+  
+  /// true, if all elements of the mask expression are true
+  template <Expression E>
+    requires std::is_same<Value_type<E>, bool>::value
+  constexpr bool all(E const& expr)
+  {
+    return AllExpr<E>(expr)();
+  }
+  
+  /// number of true elements of the mask expression
+  template <Expression E>
+    requires std::is_same<Value_type<E>, bool>::value
+  constexpr size_t count(E const& expr)
+  {
+    return CountExpr<E>(expr)();
+  }
+  
   /// euklidean distance |V1 - V2|_2
   template <VectorExpr E1, VectorExpr E2>
   auto distance(E1 const& expr1, E2 const& expr2) // NOTE: in AMDiS::absteukl
@@ -243,11 +548,24 @@ namespace AMDiS
   // ---------------------------------------------------------------------------
   // matrix-vector multiplication
   
-  /// expression for Mat * V
+  /// expression for Mat * V. The vector expression is evaluated into a
+  /// buffer first, if the cost model \ref UseBuffer decides so, e.g. for A*(B*v)
   template <MatrixExpr M, VectorExpr V>
-  auto operator*(M const& mat, V const& vec)
+  constexpr auto operator*(M const& mat, V const& vec)
+  {
+    return MatVecExpr<M, V, UseBuffer<M, V>::value>(mat, vec);
+  }
+  
+  
+  // ---------------------------------------------------------------------------
+  // matrix-matrix multiplication
+  
+  /// expression for Mat * Mat
+  template <MatrixExpr M1, MatrixExpr M2>
+    requires concepts::Multiplicable<Value_type<M1>, Value_type<M2>>
+  auto operator*(M1 const& mat1, M2 const& mat2)
   {
-    return MatVecExpr<M, V, false>(mat, vec);
+    return MatMatExpr<M1, M2>(mat1, mat2);
   }
 
   
@@ -134,16 +134,14 @@ namespace AMDiS {
     typedef typename super::value_type   value_type;
     
     /// default constructor
-    explicit StaticMatrix(size_type r = 0, size_type c = 0) : super(r, c) {}
+    explicit constexpr StaticMatrix(size_type r = 0, size_type c = 0) : super(r, c) {}
     /// constructor with initializer
-    explicit StaticMatrix(size_type r, size_type c, value_type value0) : super(r, c, value0) {}
+    explicit constexpr StaticMatrix(size_type r, size_type c, value_type value0) : super(r, c, value0) {}
     /// copy constructor
-    StaticMatrix(self const& other) : super(static_cast<super const&>(other)) {}
+    constexpr StaticMatrix(self const& other) : super(static_cast<super const&>(other)) {}
     /// constructor based on an expression    
     template <class Expr>
-    StaticMatrix(MatrixExpr<Expr> const& expr) : super(expr) {}
-    /// destructor
-    ~StaticMatrix() { }
+    constexpr StaticMatrix(MatrixExpr<Expr> const& expr) : super(expr) {}
     
     using super::operator= ;
   };
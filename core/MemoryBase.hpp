@@ -24,8 +24,14 @@
 
 #pragma once
 
+#include <boost/numeric/mtl/operation/assign_mode.hpp>
+
 #include "Log.h"			// TEST_EXIT_DBG, BOOST_STATIC_ASSERT_MSG
 #include "operations/generic_loops.hpp"	// meta::FOR
+#include "operations/packet.hpp"		// simd::assign
+#include "operations/cpu_dispatch.hpp"	// simd::cpu::assign
+#include "operations/parallel.hpp"	// parallel::for_blocks
+#include "utility/half_float.hpp"	// Half_storage, ConvertedBlock
 
 #include "Config.h"
 #include "utility/aligned_alloc.hpp"	// ALIGNED_ALLOC, ALIGNED_FREE, ...
@@ -64,19 +70,17 @@ namespace AMDiS {
     ALIGNED(T, _elements, _capacity);   // T _elements[N];
   
   protected:
-    /// default constructor
-    explicit MemoryBaseStatic(size_type s = 0) 
+    /// default constructor. The elements are value-initialized, so that 
+    /// the container can be used in constant expressions.
+    explicit constexpr MemoryBaseStatic(size_type s = 0) 
+      : _elements{}
     {
-      TEST_EXIT_DBG(s == _SIZE)("Size must be equal to capacity!\n");
+      TEST_EXIT_DBG_CONSTEXPR( s == _SIZE )("Size must be equal to capacity!\n");
     }
     
-  public:
-    /// destructor
-    ~MemoryBaseStatic() { }
-    
   public:
     /// return the \ref _size of the vector.
-    inline size_type getSize() const { return _size; }
+    constexpr size_type getSize() const { return _size; }
     
     /// return the \ref _capacity of the vector.
     static constexpr size_type getCapacity() { return _capacity; }
@@ -88,10 +92,10 @@ namespace AMDiS {
     }
       
     /// return address of contiguous memory block \ref _elements
-    inline pointer data() { return _elements; }
+    constexpr pointer data() { return _elements; }
     
     /// return address of contiguous memory block \ref _elements (const version)
-    inline const_pointer data() const { return _elements; }
+    constexpr const_pointer data() const { return _elements; }
     
     /// resize the vector. Only possible, if \p s <= _capacity
     void resize(size_type s) 
@@ -113,6 +117,17 @@ namespace AMDiS {
 // 	Assigner::apply(target(i), src(i));
     }
     
+    // same with SIMD packets and a scalar tail
+    template <class Target, Packet_expression Source, class Assigner>
+      requires simd::Packet_access<Source, T>
+    void assign_aux(Target& target, Source const& src, Assigner assigner)
+    {
+      using meta::FOR;
+      constexpr int W = simd::packet_traits<T>::size;
+      simd::assign<_SIZE>(_elements, src, assigner);
+      FOR<_SIZE - _SIZE % W, _SIZE>::assign(target, src, assigner);
+    }
+    
     template <class Functor>
     void for_each_aux(Functor f)
     {
@@ -137,7 +152,7 @@ namespace AMDiS {
     typedef MemoryBaseDynamic           self;
     
     typedef T                     value_type;
-    typedef small_t               size_type;
+    typedef size_t                size_type;   // large vectors, e.g. for the thread pool
     typedef value_type*              pointer;
     typedef value_type const*  const_pointer;
     
@@ -209,29 +224,114 @@ namespace AMDiS {
     }
     
   protected:
+    /// assignment of the expression \p src. Large assignments are split into
+    /// cache-line aligned blocks, that are assigned by the threads of the 
+    /// thread pool, see parallel::use_threads.
     template <class Target, class Source, class Assigner>
     void assign_aux(Target& target, Source const& src, Assigner assigner)
     {
-      assign_aux(target, src, assigner, bool_<aligned>());
+      assign_threaded(src, assigner, parallel::cache_line_partition<T>());
     }
     
-    template <class Target, class Source, class Assigner> // not assume aligned
-    void assign_aux(Target& target, Source const& src, Assigner assigner, false_)
+    template <class Source, class Assigner>
+    void assign_threaded(Source const& src, Assigner assigner, true_)
     {
-      for (size_type i = 0; i < _size; ++i)
-	Assigner::apply(target(i), src(i));
+      if (parallel::use_threads<T, Source>(_size)) {
+	parallel::for_blocks(_elements, _size, [&](size_t begin, size_t end) {
+	  assign_block(_elements + begin, parallel::shifted(src, begin), end - begin, assigner);
+	});
+      } else {
+	assign_block(_elements, src, _size, assigner);
+      }
     }
     
-    template <class Target, class Source, class Assigner> // assume aligned
-    void assign_aux(Target& target, Source const& src, Assigner assigner, true_)
+    // elements, that do not partition a cache line, e.g. StaticVector<double,3>:
+    // the threads would write to shared cache lines
+    template <class Source, class Assigner>
+    void assign_threaded(Source const& src, Assigner assigner, false_)
     {
-      value_type* var = (value_type*)ASSUME_ALIGNED(_elements);
-      for (size_type i = 0; i < _size; ++i)
+      assign_block(_elements, src, _size, assigner);
+    }
+    
+    /// a[i] = src(i) (or compound assignment), for i in [0, n)
+    template <class Source, class Assigner>
+    void assign_block(T* a, Source const& src, size_t n, Assigner assigner)
+    {
+#if HAS_CPU_DISPATCH
+      // kernel for the instruction set of the cpu, chosen at runtime
+      simd::cpu::assign(a, src, n, assigner);
+#else
+      assign_block(a, src, n, assigner, bool_<aligned>());
+#endif
+    }
+    
+    // SIMD packets and a scalar tail, aligned or not, with the kernel for 
+    // the instruction set of the cpu
+    template <Packet_expression Source, class Assigner>
+      requires simd::Packet_access<Source, T>
+    void assign_block(T* a, Source const& src, size_t n, Assigner assigner)
+    {
+      simd::cpu::assign(a, src, n, assigner);
+    }
+    
+    // 16-bit storage types: the expression is evaluated in float into blocks,
+    // that are rounded by the bulk conversion, see ConvertedBlock. Compound
+    // assignments convert the old values into the block first.
+    template <class Source, class Assigner>
+      requires Half_storage<T>
+    void assign_block(T* a, Source const& src, size_t n, Assigner)
+    {
+      typedef ConvertedBlock<T> Block;
+      
+      Block block;
+      for (size_t i = 0; i < n; i += Block::capacity) {
+	size_t const m = std::min(n - i, Block::capacity);
+	if (!std::is_same<Assigner, mtl::assign::assign_sum>::value)
+	  block.load(a + i, m);
+	for (size_t j = 0; j < m; ++j)
+	  Assigner::apply(block(j), src(i + j));
+	block.store(a + i, m);
+      }
+    }
+    
+    template <class Source, class Assigner> // not assume aligned
+    void assign_block(T* a, Source const& src, size_t n, Assigner assigner, false_)
+    {
+      for (size_t i = 0; i < n; ++i)
+	Assigner::apply(a[i], src(i));
+    }
+    
+    template <class Source, class Assigner> // assume aligned
+    void assign_block(T* a, Source const& src, size_t n, Assigner assigner, true_)
+    {
+      value_type* var = (value_type*)ASSUME_ALIGNED(a);
+      for (size_t i = 0; i < n; ++i)
 	Assigner::apply(var[i], src(i));
     }
     
+    /// apply \p f to all elements. Large containers are split into blocks, 
+    /// that are processed by the threads of the thread pool.
     template <class Functor>
     void for_each_aux(Functor f)
+    {
+      for_each_threaded(f, parallel::cache_line_partition<T>());
+    }
+    
+    template <class Functor>
+    void for_each_threaded(Functor f, true_)
+    {
+      if (parallel::use_threads<T, T>(_size)) {
+	parallel::for_blocks(_elements, _size, [&](size_t begin, size_t end) {
+	  for (size_t i = begin; i < end; ++i)
+	    f(_elements[i]);
+	});
+      } else {
+	for_each_threaded(f, false_());
+      }
+    }
+    
+    template <class Functor>
+    void for_each_threaded(Functor f, false_)
     {
       for (size_type i = 0; i < _size; ++i)
 	f(_elements[i]);
@@ -264,6 +364,10 @@ namespace AMDiS {
     static constexpr int _ROWS = -1;
     static constexpr int _COLS = -1;
     
+    // static bounds of the runtime sizes
+    static constexpr int _MAX_ROWS = N;
+    static constexpr int _MAX_COLS = M;
+    
   protected:
     size_type _size;
     static constexpr size_type _capacity = N*M;
@@ -314,18 +418,38 @@ namespace AMDiS {
     }
     
   protected:
+    // dispatch the runtime size to fully unrolled loops, for all sizes 
+    // in [1, _capacity]
     template <class Target, class Source, class Assigner> 
     void assign_aux(Target& target, Source const& src, Assigner assigner)
     {
-      for (size_type i = 0; i < _size; ++i)
-	Assigner::apply(target(i), src(i));
+      using meta::FOR;
+      meta::SWITCH<1,_capacity>::apply(_size, [&](auto s) {
+	FOR<0,decltype(s)::value>::assign(target, src, assigner);
+      });
+    }
+    
+    // same with SIMD packets and a scalar tail
+    template <class Target, Packet_expression Source, class Assigner>
+      requires simd::Packet_access<Source, T>
+    void assign_aux(Target& target, Source const& src, Assigner assigner)
+    {
+      using meta::FOR;
+      constexpr int W = simd::packet_traits<T>::size;
+      meta::SWITCH<1,_capacity>::apply(_size, [&](auto s) {
+	constexpr int S = decltype(s)::value;
+	simd::assign<S>(_elements, src, assigner);
+	FOR<S - S % W, S>::assign(target, src, assigner);
+      });
     }
     
     template <class Functor>
     void for_each_aux(Functor f)
     {
-      for (size_type i = 0; i < _size; ++i)
-	f(_elements[i]);
+      using meta::FOR;
+      meta::SWITCH<1,_capacity>::apply(_size, [&](auto s) {
+	FOR<0,decltype(s)::value>::for_each(_elements, f);
+      });
     }
   };
 
@@ -24,7 +24,6 @@
 
 #pragma once
 
-#include <algorithm>		// std::copy
 #include <utility>		// std::swap
 #include <initializer_list>	// std::initializer_list
 
@@ -68,50 +67,52 @@ namespace AMDiS {
   public:
     /// \brief Default constructor.
     /// allocates memory for a vector of size \p s
-    explicit VectorBase(size_type s = 0)
+    explicit constexpr VectorBase(size_type s = 0)
       : super(Size::eval(s))
     { }
     
     /// \brief Constructor with initializer.
     /// allocates memory for a vector of size \p s and sets all 
     /// entries to \p value0
-    explicit VectorBase(size_type s, value_type value0)
+    explicit constexpr VectorBase(size_type s, value_type value0)
       : super(Size::eval(s))
     {
       set(value0);
     }
     
     /// Copy constructor
-    VectorBase(self const& other)
+    constexpr VectorBase(self const& other)
       : super(other._size)
     {
-      std::copy(other._elements, other._elements + _size, _elements);
+      for (size_type i = 0; i < _size; ++i)
+	_elements[i] = other._elements[i];
     }
     
     /// \brief Constructor based on an expression.
-    /// Use the assignment operator for expressions to copy values elementwise
+    /// Static vectors are initialized elementwise, also in constant 
+    /// expressions. Otherwise, the assignment operator is used.
     template <Expression Expr>
-    VectorBase(Expr const& expr)
+    constexpr VectorBase(Expr const& expr)
       : super(size(expr))
     {
-      this->operator=(expr);
+      this->construct(expr, bool_<(Mem::_SIZE > 0)>());
     }
 
     /// constructor using initializer list
-    VectorBase(std::initializer_list<value_type> l) 
+    constexpr VectorBase(std::initializer_list<value_type> l) 
       : super(l.size())
     {
-      std::copy(l.begin(), l.end(), _elements);
+      size_type i = 0;
+      for (value_type const& v : l)
+	_elements[i++] = v;
     }
-
-    /// destructor
-    ~VectorBase() { }    
     
 #ifndef _MSC_VER // bug in MSVC <= 2013
     /// copy assignment operator
-    self& operator=(self const& other)
+    constexpr self& operator=(self const& other)
     {
-      std::copy(other.begin(), other.end(), _elements);
+      for (size_type i = 0; i < _size; ++i)
+	_elements[i] = other._elements[i];
       return *this;
     }
 #endif
@@ -137,10 +138,10 @@ namespace AMDiS {
     using super::operator() ;
     
     /// Access to the i-th vector element.
-    inline value_type& operator[](size_type i) { return _elements[i]; }
+    constexpr value_type& operator[](size_type i) { return _elements[i]; }
     
     /// Access to the i-th vector element. (const variant)
-    inline const value_type& operator[](size_type i) const { return _elements[i]; }
+    constexpr const value_type& operator[](size_type i) const { return _elements[i]; }
     
     /// Access to the i-th vector element with index checking.
     inline value_type& at(size_type i) 
@@ -160,21 +161,21 @@ namespace AMDiS {
   
   /// Size of VectorBase
   template <class M, class S>
-  size_t size(VectorBase<M,S> const& vec)
+  constexpr size_t size(VectorBase<M,S> const& vec)
   {
     return vec.getSize();
   }
   
   /// number of rows of VectorBase
   template <class M, class S>
-  size_t num_rows(VectorBase<M,S> const& vec)
+  constexpr size_t num_rows(VectorBase<M,S> const& vec)
   {
     return vec.getSize();
   }
   
   /// number of columns of VectorBase
   template <class M, class S>
-  size_t num_cols(VectorBase<M,S> const& vec)
+  constexpr size_t num_cols(VectorBase<M,S> const& vec)
   {
     return 1;
   }
@@ -131,15 +131,13 @@ namespace AMDiS {
     typedef typename super::value_type               value_type;
     
     /// default constructor
-    explicit StaticVector(size_type s = 0) : super(s) { }
+    explicit constexpr StaticVector(size_type s = 0) : super(s) { }
     /// constructor with initializer
-    explicit StaticVector(size_type s, value_type value0) : super(s, value0) {}
+    explicit constexpr StaticVector(size_type s, value_type value0) : super(s, value0) {}
     /// copy constructor
-    StaticVector(self const& other) : super(static_cast<super const&>(other)) {}
+    constexpr StaticVector(self const& other) : super(static_cast<super const&>(other)) {}
     /// assignment of an expression    
-    template <class Expr> StaticVector(VectorExpr<Expr> const& expr) : super(expr) {}
-    /// destructor
-    ~StaticVector() { }
+    template <class Expr> constexpr StaticVector(VectorExpr<Expr> const& expr) : super(expr) {}
     
     using super::operator= ;
   };
@@ -43,8 +43,18 @@ typedef size_t aligned_size_t   __attribute__ ((aligned(CACHE_LINE)));
 // ------------------------
 #define NOINLINE                __attribute__ ((noinline))
 #define ALWAYS_INLINE           __attribute__ ((always_inline))
+#define FLATTEN                 __attribute__ ((flatten))
+#define TARGET(isa)             __attribute__ ((target(isa)))
 #define OPENMODE                std::ios::openmode
 
+// runtime cpu dispatch of dynamic-size kernels
+// ---------------------------------------------
+// clang has no attribute for the floating-point contraction, compile with
+// -ffp-contract=off to get the same results for all instruction sets
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(__AVX512F__)
+  #define HAS_CPU_DISPATCH 1
+#endif
+
 // C++11 features
 // --------------
 #if __cplusplus > 199711L
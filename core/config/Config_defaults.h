@@ -57,6 +57,15 @@ typedef size_t aligned_size_t;
 #ifndef ALWAYS_INLINE
   #define ALWAYS_INLINE
 #endif
+#ifndef FLATTEN
+  #define FLATTEN
+#endif
+#ifndef TARGET
+  #define TARGET(isa)
+#endif
+#ifndef NO_FP_CONTRACT
+  #define NO_FP_CONTRACT
+#endif
 #ifndef OPENMODE
   #define OPENMODE std::ios::openmode
 #endif
@@ -65,6 +74,37 @@ typedef size_t aligned_size_t;
 	#define ASM(text)
 #endif
 
+// runtime cpu dispatch of dynamic-size kernels
+// ---------------------------------------------
+#ifndef HAS_CPU_DISPATCH
+  #define HAS_CPU_DISPATCH 0
+#endif
+
+// multithreaded assignment of large dynamic-size containers
+// ---------------------------------------------------------
+// number of threads of the thread pool, 0 := std::thread::hardware_concurrency()
+#ifndef NUM_THREADS
+  #define NUM_THREADS 0
+#endif
+// minimal estimated work (in flops, loads and stores) of an assignment, 
+// that is distributed to the threads of the pool
+#ifndef PARALLEL_MIN_WORK
+  #define PARALLEL_MIN_WORK 500000
+#endif
+
+// deterministic (parallel) reduction of large dynamic-size expressions
+// --------------------------------------------------------------------
+// reductions of more than REDUCTION_CHUNK_SIZE elements are split into chunks
+// of this size, whose partial results are combined in a fixed tree. The 
+// result does not depend on the number of threads.
+#ifndef PARALLEL_REDUCTION
+  #define PARALLEL_REDUCTION 1
+#endif
+// number of elements of a chunk, a multiple of the SIMD packet size
+#ifndef REDUCTION_CHUNK_SIZE
+  #define REDUCTION_CHUNK_SIZE 8192
+#endif
+
 // C++11 features
 // --------------
 #ifndef HAS_VARIADIC_TEMPLATES
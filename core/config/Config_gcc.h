@@ -43,10 +43,19 @@ typedef size_t aligned_size_t   __attribute__ ((aligned(CACHE_LINE)));
 // ------------------------
 #define NOINLINE                __attribute__ ((noinline))
 #define ALWAYS_INLINE           __attribute__ ((always_inline))
+#define FLATTEN                 __attribute__ ((flatten))
+#define TARGET(isa)             __attribute__ ((target(isa)))
+#define NO_FP_CONTRACT          __attribute__ ((optimize("fp-contract=off")))
 #define OPENMODE                std::ios::openmode
 
 #define ASM(text)								asm(text)
 
+// runtime cpu dispatch of dynamic-size kernels
+// ---------------------------------------------
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(__AVX512F__)
+  #define HAS_CPU_DISPATCH 1
+#endif
+
 // C++11 features
 // --------------
 #if __cplusplus > 199711L
@@ -30,8 +30,13 @@
 #include "expressions/elementwise_binary_expr.hpp"
 #include "expressions/scalar_expr.hpp"
 #include "expressions/scale_expr.hpp"
+#include "expressions/axpby_expr.hpp"
 #include "expressions/binary_expr.hpp"
+#include "expressions/indexed_expr.hpp"
+#include "expressions/where_expr.hpp"
 
 #include "expressions/reduction_unary_expr.hpp"
 #include "expressions/reduction_binary_expr.hpp"
 #include "expressions/mat_vec_expr.hpp"
+#include "expressions/mat_mat_expr.hpp"
+#include "expressions/outer_expr.hpp"
@@ -31,44 +31,70 @@
 
 namespace AMDiS {
 
+  namespace aux { struct unit_scale; }
+  
   template <class E, class F> struct ElementwiseUnaryExpr;
   template <class E1, class E2, class F> struct ElementwiseBinaryExpr;
   template <class V> struct ScalarExpr;
   template <class V, class E, bool l, class F> struct ScaleExpr;
+  template <class V1, class E1, class V2, class E2> struct AxpbyExpr;
   template <class E1, class E2, class F> struct VectorBinaryExpr;
+  template <class G, class I> struct IndexedExpr;
+  template <class A, class B, class F> struct CompareExpr;
+  template <class M, class A, class B> struct WhereExpr;
   template <class E, class F> struct ReductionUnaryExpr;
   template <class E1, class E2, class F> struct ReductionBinaryExpr;
   template <class E1, class E2, bool b> struct MatVecExpr;
+  template <class M1, class M2> struct MatMatExpr;
+  template <class V, class W> struct OuterExpr;
 
   // forward declaration of size() functions
-  template <class M, class F> size_t size(ElementwiseUnaryExpr<M,F> const&);
-  template <class E1, class E2, class F> size_t size(ElementwiseBinaryExpr<E1,E2,F> const&);
+  template <class M, class F> constexpr size_t size(ElementwiseUnaryExpr<M,F> const&);
+  template <class E1, class E2, class F> constexpr size_t size(ElementwiseBinaryExpr<E1,E2,F> const&);
   template <class V> size_t size(ScalarExpr<V> const&);
-  template <class V, class E, bool l, class F> size_t size(ScaleExpr<V,E,l,F> const&);
+  template <class V, class E, bool l, class F> constexpr size_t size(ScaleExpr<V,E,l,F> const&);
+  template <class V1, class E1, class V2, class E2> constexpr size_t size(AxpbyExpr<V1,E1,V2,E2> const&);
   template <class E1, class E2, class F> size_t size(VectorBinaryExpr<E1,E2,F> const&);
-  template <class E, class F> size_t size(ReductionUnaryExpr<E,F> const&);
-  template <class E1, class E2, class F> size_t size(ReductionBinaryExpr<E1,E2,F> const&);
-  template <class E1, class E2, bool b> size_t size(MatVecExpr<E1,E2,b> const&);
+  template <class G, class I> constexpr size_t size(IndexedExpr<G,I> const&);
+  template <class A, class B, class F> constexpr size_t size(CompareExpr<A,B,F> const&);
+  template <class M, class A, class B> constexpr size_t size(WhereExpr<M,A,B> const&);
+  template <class E, class F> constexpr size_t size(ReductionUnaryExpr<E,F> const&);
+  template <class E1, class E2, class F> constexpr size_t size(ReductionBinaryExpr<E1,E2,F> const&);
+  template <class E1, class E2, bool b> constexpr size_t size(MatVecExpr<E1,E2,b> const&);
+  template <class M1, class M2> size_t size(MatMatExpr<M1,M2> const&);
+  template <class V, class W> constexpr size_t size(OuterExpr<V,W> const&);
   
   // forward declaration of num_rows() functions
-  template <class M, class F> size_t num_rows(ElementwiseUnaryExpr<M,F> const&);
-  template <class E1, class E2, class F> size_t num_rows(ElementwiseBinaryExpr<E1,E2,F> const&);
+  template <class M, class F> constexpr size_t num_rows(ElementwiseUnaryExpr<M,F> const&);
+  template <class E1, class E2, class F> constexpr size_t num_rows(ElementwiseBinaryExpr<E1,E2,F> const&);
   template <class V> size_t num_rows(ScalarExpr<V> const&);
-  template <class V, class E, bool l, class F> size_t num_rows(ScaleExpr<V,E,l,F> const&);
+  template <class V, class E, bool l, class F> constexpr size_t num_rows(ScaleExpr<V,E,l,F> const&);
+  template <class V1, class E1, class V2, class E2> constexpr size_t num_rows(AxpbyExpr<V1,E1,V2,E2> const&);
   template <class E1, class E2, class F> size_t num_rows(VectorBinaryExpr<E1,E2,F> const&);
-  template <class E, class F> size_t num_rows(ReductionUnaryExpr<E,F> const&);
-  template <class E1, class E2, class F> size_t num_rows(ReductionBinaryExpr<E1,E2,F> const&);
-  template <class E1, class E2, bool b> size_t num_rows(MatVecExpr<E1,E2,b> const&);
+  template <class G, class I> constexpr size_t num_rows(IndexedExpr<G,I> const&);
+  template <class A, class B, class F> constexpr size_t num_rows(CompareExpr<A,B,F> const&);
+  template <class M, class A, class B> constexpr size_t num_rows(WhereExpr<M,A,B> const&);
+  template <class E, class F> constexpr size_t num_rows(ReductionUnaryExpr<E,F> const&);
+  template <class E1, class E2, class F> constexpr size_t num_rows(ReductionBinaryExpr<E1,E2,F> const&);
+  template <class E1, class E2, bool b> constexpr size_t num_rows(MatVecExpr<E1,E2,b> const&);
+  template <class M1, class M2> size_t num_rows(MatMatExpr<M1,M2> const&);
+  template <class V, class W> constexpr size_t num_rows(OuterExpr<V,W> const&);
   
   // forward declaration of num_cols() functions
-  template <class M, class F> size_t num_cols(ElementwiseUnaryExpr<M,F> const&);
-  template <class E1, class E2, class F> size_t num_cols(ElementwiseBinaryExpr<E1,E2,F> const&);
+  template <class M, class F> constexpr size_t num_cols(ElementwiseUnaryExpr<M,F> const&);
+  template <class E1, class E2, class F> constexpr size_t num_cols(ElementwiseBinaryExpr<E1,E2,F> const&);
   template <class V> size_t num_cols(ScalarExpr<V> const&);
-  template <class V, class E, bool l, class F> size_t num_cols(ScaleExpr<V,E,l,F> const&);
+  template <class V, class E, bool l, class F> constexpr size_t num_cols(ScaleExpr<V,E,l,F> const&);
+  template <class V1, class E1, class V2, class E2> constexpr size_t num_cols(AxpbyExpr<V1,E1,V2,E2> const&);
   template <class E1, class E2, class F> size_t num_cols(VectorBinaryExpr<E1,E2,F> const&);
-  template <class E, class F> size_t num_cols(ReductionUnaryExpr<E,F> const&);
-  template <class E1, class E2, class F> size_t num_cols(ReductionBinaryExpr<E1,E2,F> const&);
-  template <class E1, class E2, bool b> size_t num_cols(MatVecExpr<E1,E2,b> const&);
+  template <class G, class I> constexpr size_t num_cols(IndexedExpr<G,I> const&);
+  template <class A, class B, class F> constexpr size_t num_cols(CompareExpr<A,B,F> const&);
+  template <class M, class A, class B> constexpr size_t num_cols(WhereExpr<M,A,B> const&);
+  template <class E, class F> constexpr size_t num_cols(ReductionUnaryExpr<E,F> const&);
+  template <class E1, class E2, class F> constexpr size_t num_cols(ReductionBinaryExpr<E1,E2,F> const&);
+  template <class E1, class E2, bool b> constexpr size_t num_cols(MatVecExpr<E1,E2,b> const&);
+  template <class M1, class M2> size_t num_cols(MatMatExpr<M1,M2> const&);
+  template <class V, class W> constexpr size_t num_cols(OuterExpr<V,W> const&);
   
 } // end namespace AMDiS
 
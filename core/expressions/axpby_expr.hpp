@@ -0,0 +1,200 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file axpby_expr.hpp */
+
+#pragma once
+
+#include "Log.h"			// TEST_EXIT_DBG_CONSTEXPR
+#include <type_traits>
+
+#include "traits/concepts.hpp"
+#include "traits/size.hpp"
+#include "traits/num_rows.hpp"
+#include "traits/num_cols.hpp"
+#include "traits/compute_type.hpp"
+#include "traits/mult_type.hpp"
+#include "traits/store_type.hpp"
+#include "operations/packet.hpp"
+
+namespace AMDiS {
+
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    /// factor 1 known at compile-time, i.e. y in a*x + y is not scaled
+    struct unit_scale {};
+    
+    template <class T>
+    constexpr T scale(unit_scale, T const& y) { return y; }
+    
+    template <class V, class T>
+    constexpr T scale(V const& b, T const& y) { return T(b) * y; }
+    
+    /// a*x + b*y, with the same operations for scalars and SIMD packets, 
+    /// so that the elements of the packets and of the scalar tail are 
+    /// rounded alike.
+    template <class T, class V>
+    constexpr T axpby(T const& a, T const& x, V const& b, T const& y) { return a * x + scale(b, y); }
+    
+  } // end namespace aux
+  /// \endcond
+  
+  
+  /// \brief a*X + b*Y can be fused without changing the result, i.e. 
+  /// X and Y have the same value type, that is not changed by the factor.
+  template <class V, class E1, class E2>
+  concept bool Axpby_exact = 
+    std::is_same<Value_type<E1>, Value_type<E2>>::value &&
+    std::is_same<traits::mult_type<V, Value_type<E1>>, Value_type<E1>>::value;
+  
+  
+  /// \brief Expression for a*X + b*Y, evaluated in one pass.
+  /** Created by the rewrite rules in MatrixVectorOperations.hpp for the 
+   *  BLAS-1 shapes a*x + y, x + a*y, a*x + b*y and x - a*y, if the fused 
+   *  expression is exact, see \ref Axpby_exact. If the second argument is 
+   *  not scaled, \p V2 is aux::unit_scale. The elements are a*x + b*y in the
+   *  common type of the factors and the elements, in the packets and in the 
+   *  tail alike. The gain is the single pass over the data: the products are
+   *  not fused with the addition, since the kernels are compiled with 
+   *  NO_FP_CONTRACT (-ffp-contract=off for clang), so that the values equal 
+   *  those of the unfused expression on all instruction sets.
+   **/
+  template <Arithmetic V1, Expression E1, class V2, Expression E2>
+  struct AxpbyExprBase
+  {
+    typedef AxpbyExprBase                                 self;
+    
+    typedef traits::compute_type<decltype( std::declval<V1>() * std::declval<Value_type<E1>>() 
+	    + aux::scale(std::declval<V2>(), std::declval<Value_type<E2>>()) )> value_type;
+    typedef traits::max_size_type<E1,E2>             size_type;
+    typedef E1                                      expr1_type;
+    typedef E2                                      expr2_type;
+    
+    static constexpr int _SIZE = max(E1::_SIZE, E2::_SIZE);
+    static constexpr int _ROWS = max(E1::_ROWS, E2::_ROWS);
+    static constexpr int _COLS = max(E1::_COLS, E2::_COLS);
+    
+    /// constructor takes the factors \p alpha, \p beta and the expressions \p X, \p Y
+    constexpr AxpbyExprBase(V1 alpha, expr1_type const& X, V2 beta, expr2_type const& Y) 
+	: a(alpha), b(beta), expr1(X), expr2(Y)
+    { 
+      TEST_EXIT_DBG_CONSTEXPR( size(X) == size(Y) )("Sizes do not match!\n");
+    }
+    
+    /// access the elements of an expr.
+    constexpr value_type operator()(size_type i) const
+    { 
+      return aux::axpby(value_type(a), value_type(expr1(i)), b, value_type(expr2(i)));
+    }
+    
+    /// access the elements [i, i+W) of an expr. as SIMD packet.
+    template <int Bytes = SIMD_BYTES>
+    inline simd::Packet<value_type, Bytes> packet(size_type i) const
+      requires simd::Packet_access<E1, value_type> && simd::Packet_access<E2, value_type>
+    { 
+      return simd::broadcast<Bytes>(value_type(a)) * expr1.template packet<Bytes>(i) 
+	+ scale_packet(b, expr2.template packet<Bytes>(i));
+    }
+    
+    V1 get_first_factor() const { return a; }
+    V2 get_second_factor() const { return b; }
+    
+    constexpr expr1_type const& get_first() const { return expr1; }
+    constexpr expr2_type const& get_second() const { return expr2; }
+    
+  protected:
+    template <class P>
+    static P scale_packet(aux::unit_scale, P const& y) { return y; }
+    
+    template <class V, class P>
+    static P scale_packet(V const& b, P const& y) { return simd::broadcast<sizeof(P)>(value_type(b)) * y; }
+    
+  protected:
+    V1 a;
+    V2 b;
+    traits::store_type<E1> expr1;
+    traits::store_type<E2> expr2;
+  };
+  
+  
+  template <Arithmetic V1, Expression E1, class V2, Expression E2>
+  struct AxpbyExpr {};
+  
+  
+  // fused vector expressions
+  template <Arithmetic V1, VectorExpr E1, class V2, VectorExpr E2>
+  struct AxpbyExpr<V1, E1, V2, E2>
+    : public AxpbyExprBase<V1, E1, V2, E2>
+  {
+    typedef AxpbyExprBase<V1, E1, V2, E2>  super;
+    constexpr AxpbyExpr(V1 a, E1 const& e1, V2 b, E2 const& e2) : super(a, e1, b, e2) { }
+  };
+    
+  
+  // fused matrix expressions
+  template <Arithmetic V1, MatrixExpr E1, class V2, MatrixExpr E2>
+  struct AxpbyExpr<V1, E1, V2, E2>
+    : public AxpbyExprBase<V1, E1, V2, E2>
+  {
+    typedef AxpbyExprBase<V1, E1, V2, E2>  super;
+    typedef typename super::value_type value_type;
+    
+    constexpr AxpbyExpr(V1 a, E1 const& e1, V2 b, E2 const& e2) : super(a, e1, b, e2) { }
+    
+    /// access the elements of a matrix-expr.
+    constexpr value_type 
+    operator()(typename super::size_type i, typename super::size_type j) const
+    { 
+      return aux::axpby(value_type(super::a), value_type(super::expr1(i, j)), 
+			super::b, value_type(super::expr2(i, j)));
+    }
+    using super::operator();
+  };
+  
+  
+  /// Size of AxpbyExpr
+  template <class V1, class E1, class V2, class E2>
+  constexpr size_t size(AxpbyExpr<V1, E1, V2, E2> const& expr)
+  {
+    return size(expr.get_first());
+  }
+  
+  /// number of rows of AxpbyExpr
+  template <class V1, class E1, class V2, class E2>
+  constexpr size_t num_rows(AxpbyExpr<V1, E1, V2, E2> const& expr)
+  {
+    return num_rows(expr.get_first());
+  }
+  
+  /// number of columns of AxpbyExpr
+  template <class V1, class E1, class V2, class E2>
+  constexpr size_t num_cols(AxpbyExpr<V1, E1, V2, E2> const& expr)
+  {
+    return num_cols(expr.get_first());
+  }
+
+  // a*X + Y
+  template <class V, class E1, class E2>
+  using AxpyExpr = AxpbyExpr<V, E1, aux::unit_scale, E2>;
+  
+} // end namespace AMDiS
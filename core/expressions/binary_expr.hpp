@@ -24,19 +24,104 @@
 
 #pragma once
 
+#include <vector>
+
 #include "traits/concepts.hpp"
 #include "traits/size.hpp"
 #include "traits/num_rows.hpp"
 #include "traits/num_cols.hpp"
+#include "traits/store_type.hpp"
+#include "traits/compute_type.hpp"
+#include "traits/eval_cost.hpp"
 
 #include "traits/base_expr.hpp" // for shaped_expr
 
 #include "operations/functors.hpp"
+#include "operations/generic_loops.hpp"	// meta::UNROLL
 // #include "traits/mult_type.hpp"
 
 namespace AMDiS {
 
-  /// Expression with two arguments
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    /// \brief elements of an expression evaluated once into local memory.
+    /** Used by expressions that access their arguments not elementwise, e.g.
+     *  the cross-product, so that each element of an argument expression is
+     *  computed only once. Static sizes are kept on the stack.
+     **/
+    template <class T, int N>
+    struct EvalBuffer
+    {
+      typedef T                     value_type;
+      typedef small_t                size_type;
+      
+      static constexpr int _SIZE = N;
+      
+      template <class E>
+      explicit EvalBuffer(E const& expr)
+      {
+	meta::UNROLL<0,N>::apply([&](auto i) { data[i] = expr(i); });
+      }
+      
+      inline value_type operator()(size_type i) const { return data[i]; }
+      
+      value_type data[N];
+    };
+    
+    template <class T>
+    struct EvalBuffer<T, -1>
+    {
+      typedef T                     value_type;
+      typedef size_t                 size_type;
+      
+      static constexpr int _SIZE = -1;
+      
+      template <class E>
+      explicit EvalBuffer(E const& expr) 
+	: data(size(expr))
+      {
+	for (size_type i = 0; i < data.size(); ++i)
+	  data[i] = expr(i);
+      }
+      
+      inline value_type operator()(size_type i) const { return data[i]; }
+      
+      std::vector<value_type> data;
+    };
+    
+    template <class T, int N>
+    size_t size(EvalBuffer<T, N> const&) { return N; }
+    
+    template <class T>
+    size_t size(EvalBuffer<T, -1> const& buffer) { return buffer.data.size(); }
+    
+    template <class T, int N>
+    size_t num_rows(EvalBuffer<T, N> const& buffer) { return size(buffer); }
+    
+    template <class T, int N>
+    size_t num_cols(EvalBuffer<T, N> const&) { return 1; }
+    
+    /// arguments that are not containers or scalars are evaluated into an 
+    /// EvalBuffer, all others are stored as usual
+    template <class E>
+    using BufferedArg = 
+	if_then_else< (traits::eval_cost<E>::value > 0),
+		      EvalBuffer<traits::compute_type<Value_type<E>>, E::_SIZE>,
+		      traits::store_type<E> >;
+    
+  } // end namespace aux
+  /// \endcond
+  
+
+  /// \brief Expression with two arguments.
+  /** The \p Functor may access the arguments not elementwise, i.e. 
+   *  Functor::apply(i, expr1, expr2) can read several elements of the 
+   *  arguments. Arguments, that are not containers or scalars, e.g. (a+b) in 
+   *  cross(a+b, c), are evaluated once into a buffer on construction, so 
+   *  that they are not recomputed for each element, also if the expression 
+   *  is part of a larger one, like dot(cross(a+b, c), d).
+   **/
   template <VectorExpr E1, VectorExpr E2, class Functor>
   struct VectorBinaryExpr
   {
@@ -71,12 +156,40 @@ namespace AMDiS {
 //       return Functor::apply( i, j, expr1, expr2 );
 //     }
     
-    expr1_type const& get_first() const { return expr1; }
-    expr2_type const& get_second() const { return expr2; }
+    /// \brief evaluate the whole expression and assign it to \p target.
+    /** The arguments are copied into local buffers, so that the target can 
+     *  be one of the arguments, e.g. v = cross(v, w). Since the target is 
+     *  written only after the arguments are copied, aliasing is not an issue.
+     **/
+    template <class Target, class Assigner>
+    void assign_to(Target& target, Assigner) const
+    {
+      aux::EvalBuffer<traits::compute_type<Value_type<E1>>, E1::_SIZE> const a(expr1);
+      aux::EvalBuffer<traits::compute_type<Value_type<E2>>, E2::_SIZE> const b(expr2);
+      
+      assign_to(target, a, b, Assigner(), int_<_SIZE>());
+    }
+    
+    aux::BufferedArg<E1> const& get_first() const { return expr1; }
+    aux::BufferedArg<E2> const& get_second() const { return expr2; }
+    
+  protected:
+    template <class Target, class A, class B, class Assigner, int N>
+    void assign_to(Target& target, A const& a, B const& b, Assigner, int_<N>) const
+    {
+      meta::UNROLL<0,N>::apply([&](auto i) { Assigner::apply(target(i), Functor::apply(i, a, b)); });
+    }
+    
+    template <class Target, class A, class B, class Assigner>
+    void assign_to(Target& target, A const& a, B const& b, Assigner, int_<-1>) const
+    {
+      for (size_t i = 0; i < size(a); ++i)
+	Assigner::apply(target(i), Functor::apply(i, a, b));
+    }
     
   private:
-    expr1_type const& expr1;
-    expr2_type const& expr2;
+    aux::BufferedArg<E1> expr1;
+    aux::BufferedArg<E2> expr2;
   };
   
   /// Size of VectorBinaryExpr
@@ -24,12 +24,16 @@
 
 #pragma once
 
-#include <boost/numeric/mtl/operation/sfunctor.hpp>
+#include "Log.h"			// TEST_EXIT_DBG_CONSTEXPR
+
 
 #include "traits/concepts.hpp"
 #include "traits/size.hpp"
 #include "traits/num_rows.hpp"
 #include "traits/num_cols.hpp"
+#include "traits/store_type.hpp"
+#include "operations/functors.hpp"
+#include "operations/packet.hpp"
 
 #include "traits/base_expr.hpp" // for ShapedExpr
 
@@ -52,24 +56,34 @@ namespace AMDiS {
     static constexpr int _COLS = max(E1::_COLS, E2::_COLS);
     
     /// constructor takes two expressions
-    ElementwiseBinaryExprBase(expr1_type const& A, expr2_type const& B) 
+    constexpr ElementwiseBinaryExprBase(expr1_type const& A, expr2_type const& B) 
 	: expr1(A), expr2(B) 
     { 
-      TEST_EXIT_DBG( size(A) == size(B) )("Sizes do not match!\n");
+      TEST_EXIT_DBG_CONSTEXPR( size(A) == size(B) )("Sizes do not match!\n");
     }
     
     /// access the elements of an expr.
-    inline value_type operator()(size_type i) const
+    constexpr value_type operator()(size_type i) const
     { 
       return F::apply( expr1(i), expr2(i) );
     }
     
-    expr1_type const& get_first() const { return expr1; }
-    expr2_type const& get_second() const { return expr2; }
+    /// access the elements [i, i+W) of an expr. as SIMD packet.
+    template <int Bytes = SIMD_BYTES>
+    inline simd::Packet<value_type, Bytes> packet(size_type i) const
+      requires simd::Packet_access<E1, value_type> && 
+	       simd::Packet_access<E2, value_type> && simd::packet_functor<F>::value
+    { 
+      return simd::packet_functor<F>::apply( expr1.template packet<Bytes>(i), 
+					     expr2.template packet<Bytes>(i) );
+    }
+    
+    constexpr expr1_type const& get_first() const { return expr1; }
+    constexpr expr2_type const& get_second() const { return expr2; }
     
   private:
-    expr1_type const& expr1;
-    expr2_type const& expr2;
+    traits::store_type<E1> expr1;
+    traits::store_type<E2> expr2;
   };
   
   
@@ -83,7 +97,7 @@ namespace AMDiS {
     : public ElementwiseBinaryExprBase<E1, E2, F>
   {
     typedef ElementwiseBinaryExprBase<E1, E2, F>  super;
-    ElementwiseBinaryExpr(E1 const& e1, E2 const& e2) : super(e1, e2) { }
+    constexpr ElementwiseBinaryExpr(E1 const& e1, E2 const& e2) : super(e1, e2) { }
   };
     
   
@@ -93,10 +107,10 @@ namespace AMDiS {
     : public ElementwiseBinaryExprBase<E1, E2, F>
   {
     typedef ElementwiseBinaryExprBase<E1, E2, F>  super;
-    ElementwiseBinaryExpr(E1 const& e1, E2 const& e2) : super(e1, e2) { }
+    constexpr ElementwiseBinaryExpr(E1 const& e1, E2 const& e2) : super(e1, e2) { }
     
     /// access the elements of a matrix-expr.
-    inline typename super::value_type 
+    constexpr typename super::value_type 
     operator()(typename super::size_type i, typename super::size_type j) const
     { 
       return F::apply( super::expr1(i, j), super::expr2(i, j) );
@@ -107,21 +121,21 @@ namespace AMDiS {
   
   /// Size of ElementwiseBinaryExpr
   template <class E1, class E2, class F>
-  size_t size(ElementwiseBinaryExpr<E1, E2, F> const& expr)
+  constexpr size_t size(ElementwiseBinaryExpr<E1, E2, F> const& expr)
   {
     return size(expr.get_first());
   }
   
   /// number of rows of ElementwiseBinaryExpr
   template <class E1, class E2, class F>
-  size_t num_rows(ElementwiseBinaryExpr<E1, E2, F> const& expr)
+  constexpr size_t num_rows(ElementwiseBinaryExpr<E1, E2, F> const& expr)
   {
     return num_rows(expr.get_first());
   }
   
   /// number of columns of ElementwiseBinaryExpr
   template <class E1, class E2, class F>
-  size_t num_cols(ElementwiseBinaryExpr<E1, E2, F> const& expr)
+  constexpr size_t num_cols(ElementwiseBinaryExpr<E1, E2, F> const& expr)
   {
     return num_cols(expr.get_first());
   }
@@ -130,13 +144,13 @@ namespace AMDiS {
   template <class E1, class E2>
   using PlusExpr =
     ElementwiseBinaryExpr<E1, E2, 
-      mtl::sfunctor::plus<Value_type<E1>, Value_type<E2> > >;
+      functors::plus<Value_type<E1>, Value_type<E2> > >;
       
   // E1 - E2
   template <class E1, class E2>
   using MinusExpr =
     ElementwiseBinaryExpr<E1, E2, 
-      mtl::sfunctor::minus<Value_type<E1>, Value_type<E2> > >;
+      functors::minus<Value_type<E1>, Value_type<E2> > >;
       
   
 } // end namespace AMDiS
@@ -28,6 +28,8 @@
 #include "traits/size.hpp"
 #include "traits/num_rows.hpp"
 #include "traits/num_cols.hpp"
+#include "traits/store_type.hpp"
+#include "operations/packet.hpp"
 
 #include "traits/base_expr.hpp" // for ShapedExpr
 
@@ -49,20 +51,28 @@ namespace AMDiS {
     static constexpr int _COLS = E::_COLS;
     
     /// constructor takes an expression
-    ElementwiseUnaryExprBase(expr_type const& A) 
+    constexpr ElementwiseUnaryExprBase(expr_type const& A) 
 	: expr(A) 
     { }
     
     /// access the elements of an expr.
-    inline value_type operator()(size_type i) const
+    constexpr value_type operator()(size_type i) const
     { 
       return F::apply( expr(i) );
     }
     
-    expr_type const& get_first() const { return expr; }
+    /// access the elements [i, i+W) of an expr. as SIMD packet.
+    template <int Bytes = SIMD_BYTES>
+    inline simd::Packet<value_type, Bytes> packet(size_type i) const
+      requires simd::Packet_access<E, value_type> && simd::packet_functor<F>::value
+    { 
+      return simd::packet_functor<F>::apply( expr.template packet<Bytes>(i) );
+    }
+    
+    constexpr expr_type const& get_first() const { return expr; }
     
   private:
-    expr_type const& expr;
+    traits::store_type<E> expr;
   };
   
   
@@ -75,7 +85,7 @@ namespace AMDiS {
     : public ElementwiseUnaryExprBase<E, F>
   {
     typedef ElementwiseUnaryExprBase<E, F>  super;
-    ElementwiseUnaryExpr(E const& expr) : super(expr) { }
+    constexpr ElementwiseUnaryExpr(E const& expr) : super(expr) { }
   };
   
   
@@ -84,10 +94,10 @@ namespace AMDiS {
     : public ElementwiseUnaryExprBase<E, F>
   {
     typedef ElementwiseUnaryExprBase<E, F>  super;
-    ElementwiseUnaryExpr(E const& expr) : super(expr) { }
+    constexpr ElementwiseUnaryExpr(E const& expr) : super(expr) { }
     
     /// access the elements of a matrix-expr.
-    inline typename super::value_type 
+    constexpr typename super::value_type 
     operator()(typename super::size_type i, typename super::size_type j) const
     { 
       return F::apply( super::expr(i, j) );
@@ -98,21 +108,21 @@ namespace AMDiS {
   
   /// Size of ElementwiseUnaryExpr
   template <class E, class F>
-  size_t size(ElementwiseUnaryExpr<E, F> const& expr)
+  constexpr size_t size(ElementwiseUnaryExpr<E, F> const& expr)
   {
     return size(expr.get_first());
   }
   
   /// number of rows of ElementwiseUnaryExpr
   template <class E, class F>
-  size_t num_rows(ElementwiseUnaryExpr<E, F> const& expr)
+  constexpr size_t num_rows(ElementwiseUnaryExpr<E, F> const& expr)
   {
     return num_rows(expr.get_first());
   }
   
   /// number of columns of ElementwiseUnaryExpr
   template <class E, class F>
-  size_t num_cols(ElementwiseUnaryExpr<E, F> const& expr)
+  constexpr size_t num_cols(ElementwiseUnaryExpr<E, F> const& expr)
   {
     return num_cols(expr.get_first());
   }
@@ -0,0 +1,109 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file indexed_expr.hpp */
+
+#pragma once
+
+#include "Log.h"			// TEST_EXIT_DBG_CONSTEXPR
+
+#include "traits/concepts.hpp"
+#include "traits/size.hpp"
+#include "traits/num_rows.hpp"
+#include "traits/num_cols.hpp"
+#include "traits/store_type.hpp"
+#include "operations/packet.hpp"	// simd::gather
+
+namespace AMDiS {
+
+  /// \brief Expression for the indirect access global(idx(i)), e.g. to gather
+  /// the element-local values of a global vector.
+  /** The expression has the size of the index vector \p I, i.e. a static 
+   *  index vector results in an expression of static size. If both, \p G and
+   *  \p I, are containers, the elements are accessed by SIMD gather.
+   **/
+  template <VectorExpr G, VectorExpr I>
+    requires Integral<Value_type<I>>
+  struct IndexedExpr
+  {
+    typedef IndexedExpr                 self;
+    
+    typedef Value_type<G>         value_type;
+    typedef Size_type<I>           size_type;
+    typedef G                    global_type;
+    typedef I                     index_type;
+    
+    static constexpr int _SIZE = I::_SIZE;
+    static constexpr int _ROWS = I::_SIZE;
+    static constexpr int _COLS = 1;
+    
+    /// constructor takes the global expression \p g and the indices \p idx
+    constexpr IndexedExpr(global_type const& g, index_type const& idx) 
+      : global(g), index(idx)
+    { }
+    
+    /// access the elements of an expr.
+    constexpr value_type operator()(size_type i) const
+    { 
+      TEST_EXIT_DBG_CONSTEXPR( size_t(index(i)) < size(global) )("Index out of range!\n");
+      return global(index(i));
+    }
+    
+    /// gather the elements [i, i+W) of an expr. as SIMD packet.
+    template <int Bytes = SIMD_BYTES>
+    inline simd::Packet<value_type, Bytes> packet(size_type i) const
+      requires Memory_policy<G> && Memory_policy<I> && (simd::packet_traits<value_type>::size > 1)
+    { 
+      return simd::gather(global.data(), index.data() + i, int_<Bytes>());
+    }
+    
+    constexpr global_type const& get_global() const { return global; }
+    constexpr index_type const& get_index() const { return index; }
+    
+  private:
+    traits::store_type<G> global;
+    traits::store_type<I> index;
+  };
+  
+  
+  /// Size of IndexedExpr
+  template <class G, class I>
+  constexpr size_t size(IndexedExpr<G, I> const& expr)
+  {
+    return size(expr.get_index());
+  }
+  
+  /// number of rows of IndexedExpr
+  template <class G, class I>
+  constexpr size_t num_rows(IndexedExpr<G, I> const& expr)
+  {
+    return size(expr.get_index());
+  }
+  
+  /// number of columns of IndexedExpr
+  template <class G, class I>
+  constexpr size_t num_cols(IndexedExpr<G, I> const& expr)
+  {
+    return 1;
+  }
+  
+} // end namespace AMDiS
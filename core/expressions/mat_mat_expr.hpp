@@ -0,0 +1,265 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file MatMatExpr.hpp */
+
+#pragma once
+
+#include <algorithm>	// std::fill, std::min
+#include <vector>
+
+#include <boost/numeric/linear_algebra/identity.hpp>	// mtl::math::zero
+
+#include "traits/concepts.hpp"
+#include "traits/num_rows.hpp"
+#include "traits/num_cols.hpp"
+#include "traits/base_expr.hpp"
+#include "traits/compute_type.hpp"
+#include "traits/mult_type.hpp"
+#include "traits/store_type.hpp"
+#include "traits/aliasing.hpp"		// aliases
+#include "operations/meta.hpp"
+#include "operations/generic_loops.hpp"	// meta::UNROLL
+#include "operations/packet.hpp"		// simd::packet_traits
+
+namespace AMDiS {
+  
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    /// maximal static size for which the fully unrolled kernel is used
+    static constexpr int MAT_MAT_UNROLL_MAX = 8;
+    
+    /// number of rows of a register tile of the unrolled kernel
+    static constexpr int MAT_MAT_TILE_ROWS = 4;
+    
+    /// block size of the cache-blocked kernel (in rows/cols)
+    static constexpr size_t MAT_MAT_BLOCK = 32;
+    
+    /// size of the stack buffer for the result of the dynamic kernel
+    static constexpr size_t MAT_MAT_STACK = 64;
+  }
+  /// \endcond
+  
+  
+  /// \brief Expression with two arguments, that multiplies two matrix_exprs
+  /** Element access via operator()(i,j) computes a single inner product 
+   *  and is used if the product is part of a larger expression. Assignment
+   *  of the product to a matrix uses \ref assign_to, that evaluates the 
+   *  whole product with a blocked kernel: fully unrolled with register tiles
+   *  of 4 rows and one SIMD width of columns for static sizes <= 8x8, 
+   *  cache-blocked for dynamic sizes.
+   **/
+  template <MatrixExpr M1, MatrixExpr M2>
+  struct MatMatExpr
+  {
+    typedef MatMatExpr                                           self;
+    
+    typedef traits::mult_type< traits::compute_type<Value_type<M1>>, 
+			       traits::compute_type<Value_type<M2>> > value_type;
+    typedef traits::max_size_type<M1, M2>                    size_type;
+	
+    typedef M1                                             matrix1_type;
+    typedef M2                                             matrix2_type;
+    
+    // sizes of the resulting expr.
+    static constexpr int _ROWS = M1::_ROWS;
+    static constexpr int _COLS = M2::_COLS;
+    static constexpr int _SIZE = (_ROWS > 0 && _COLS > 0 ? _ROWS * _COLS : -1);
+    
+  private:
+    // size of the contracted dimension
+    static constexpr int INNER = max(M1::_COLS, M2::_ROWS);
+    
+    static constexpr bool use_unrolled = _ROWS > 0 && _COLS > 0 && INNER > 0 &&
+      _ROWS <= aux::MAT_MAT_UNROLL_MAX && 
+      _COLS <= aux::MAT_MAT_UNROLL_MAX && 
+      INNER <= aux::MAT_MAT_UNROLL_MAX;
+    
+    // size of the register tiles of the unrolled kernel
+    static constexpr int TILE_ROWS = min(aux::MAT_MAT_TILE_ROWS, max(_ROWS, 1));
+    static constexpr int TILE_COLS = min(simd::packet_traits<value_type>::size, max(_COLS, 1));
+    
+  public:
+    /// constructor takes two matrix expressions \p A and \p B for the 
+    /// matrix-matrix product A*B.
+    MatMatExpr(matrix1_type const& A, matrix2_type const& B) 
+	: matrix1(A), matrix2(B)
+    { 
+      TEST_EXIT_DBG( num_cols(A) == num_rows(B) )("Sizes do not match!\n");
+    }
+    
+    /// access the elements of a matrix-expr.
+    inline value_type operator()(size_type i, size_type j) const
+    {
+      return reduce(i, j, int_<INNER>());
+    }
+    
+    /// access the elements of an expr. (row-major, contiguous index)
+    inline value_type operator()(size_type i) const
+    {
+      size_type c = size_type(num_cols(matrix2));
+      return reduce(size_type(i / c), size_type(i % c), int_<INNER>());
+    }
+    
+    /// evaluate the whole product and assign it to \p target using the 
+    /// compound assignment given by \p Assigner: target (op)= A*B
+    template <class Target, class Assigner>
+    void assign_to(Target& target, Assigner assigner) const
+    {
+      assign_to(target, assigner, bool_<use_unrolled>());
+    }
+    
+    matrix1_type const& get_first() const { return matrix1; }
+    matrix2_type const& get_second() const { return matrix2; }
+    
+  protected:
+    // single element, contracted dimension known at compile-time
+    template <int N> requires (N > 0)
+    inline value_type reduce(size_type r, size_type c, int_<N>) const
+    {
+      using meta::UNROLL;
+      value_type erg = math::zero(value_type());
+      UNROLL<0,N>::apply([&](auto k) { erg += matrix1(r, k) * matrix2(k, c); });
+      return erg;
+    }
+    
+    // single element, contracted dimension known at runtime
+    inline value_type reduce(size_type r, size_type c, int_<-1>) const
+    {
+      value_type erg = math::zero(value_type());
+      for (size_type k = 0; k < num_cols(matrix1); ++k)
+	erg += matrix1(r, k) * matrix2(k, c);
+      return erg;
+    }
+    
+    // fully unrolled kernel: the result is computed in tiles of TILE_ROWS x 
+    // TILE_COLS, that are kept in registers and stored when complete. If the 
+    // target aliases an argument, the product is evaluated into a temporary.
+    template <class Target, class Assigner>
+    void assign_to(Target& target, Assigner, true_) const
+    {
+      using meta::UNROLL;
+      if (aliases(matrix1, target.data(), target.data() + target.getSize()) || 
+	  aliases(matrix2, target.data(), target.data() + target.getSize())) {
+	Target const tmp(*this);
+	UNROLL<0,_ROWS>::apply([&](auto i) {
+	  UNROLL<0,_COLS>::apply([&](auto j) { Assigner::apply(target(i, j), tmp(i, j)); });
+	});
+	return;
+      }
+      
+      UNROLL<0, (_ROWS + TILE_ROWS - 1) / TILE_ROWS>::apply([&](auto ti) {
+	constexpr int i0 = decltype(ti)::value * TILE_ROWS;
+	constexpr int i1 = min(i0 + TILE_ROWS, _ROWS);
+	
+	UNROLL<0, (_COLS + TILE_COLS - 1) / TILE_COLS>::apply([&](auto tj) {
+	  constexpr int j0 = decltype(tj)::value * TILE_COLS;
+	  constexpr int j1 = min(j0 + TILE_COLS, _COLS);
+	  
+	  value_type C[i1 - i0][j1 - j0];
+	  UNROLL<i0,i1>::apply([&](auto i) {
+	    UNROLL<j0,j1>::apply([&](auto j) { C[i - i0][j - j0] = math::zero(value_type()); });
+	  });
+	  UNROLL<0,INNER>::apply([&](auto k) {
+	    UNROLL<i0,i1>::apply([&](auto i) {
+	      value_type const a = matrix1(i, k);
+	      UNROLL<j0,j1>::apply([&](auto j) { C[i - i0][j - j0] += a * matrix2(k, j); });
+	    });
+	  });
+	  
+	  UNROLL<i0,i1>::apply([&](auto i) {
+	    UNROLL<j0,j1>::apply([&](auto j) { Assigner::apply(target(i, j), C[i - i0][j - j0]); });
+	  });
+	});
+      });
+    }
+    
+    // cache-blocked kernel for dynamic (or large static) sizes
+    template <class Target, class Assigner>
+    void assign_to(Target& target, Assigner, false_) const
+    {
+      using aux::MAT_MAT_BLOCK;
+      size_t const rows = num_rows(matrix1), cols = num_cols(matrix2), inner = num_cols(matrix1);
+      
+      // the result is computed in a temporary, so that target may alias the arguments
+      value_type stack_buffer[aux::MAT_MAT_STACK];
+      std::vector<value_type> heap_buffer;
+      value_type* C = stack_buffer;
+      if (rows * cols > aux::MAT_MAT_STACK) {
+	heap_buffer.resize(rows * cols);
+	C = heap_buffer.data();
+      }
+      std::fill(C, C + rows * cols, math::zero(value_type()));
+      
+      for (size_t i0 = 0; i0 < rows; i0 += MAT_MAT_BLOCK) {
+	size_t const i1 = std::min(i0 + MAT_MAT_BLOCK, rows);
+	for (size_t k0 = 0; k0 < inner; k0 += MAT_MAT_BLOCK) {
+	  size_t const k1 = std::min(k0 + MAT_MAT_BLOCK, inner);
+	  for (size_t j0 = 0; j0 < cols; j0 += MAT_MAT_BLOCK) {
+	    size_t const j1 = std::min(j0 + MAT_MAT_BLOCK, cols);
+	    
+	    for (size_t i = i0; i < i1; ++i) {
+	      value_type* C_i = C + i * cols;
+	      for (size_t k = k0; k < k1; ++k) {
+		value_type const a = matrix1(size_type(i), size_type(k));
+		for (size_t j = j0; j < j1; ++j)
+		  C_i[j] += a * matrix2(size_type(k), size_type(j));
+	      }
+	    }
+	  }
+	}
+      }
+      
+      for (size_t i = 0; i < rows; ++i)
+	for (size_t j = 0; j < cols; ++j)
+	  Assigner::apply(target(size_type(i), size_type(j)), C[i * cols + j]);
+    }
+    
+  private:
+    traits::store_type<M1>  matrix1;
+    traits::store_type<M2>  matrix2;
+  };
+  
+  
+  /// Size of MatMatExpr
+  template <class M1, class M2>
+  size_t size(MatMatExpr<M1,M2> const& expr)
+  {
+    return num_rows(expr.get_first()) * num_cols(expr.get_second());
+  }
+  
+  /// number of rows of MatMatExpr
+  template <class M1, class M2>
+  size_t num_rows(MatMatExpr<M1,M2> const& expr)
+  {
+    return num_rows(expr.get_first());
+  }
+  
+  /// number of columns of MatMatExpr
+  template <class M1, class M2>
+  size_t num_cols(MatMatExpr<M1,M2> const& expr)
+  {
+    return num_cols(expr.get_second());
+  }
+  
+} // end namespace AMDiS
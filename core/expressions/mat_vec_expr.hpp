@@ -24,13 +24,17 @@
 
 #pragma once
 
-#include <boost/numeric/linear_algebra/identity.hpp>	// mtl::math::zero
+#include "Log.h"			// TEST_EXIT_DBG_CONSTEXPR
 
 #include "traits/concepts.hpp"
 #include "traits/num_rows.hpp"
 #include "traits/num_cols.hpp"
 #include "traits/base_expr.hpp"
+#include "traits/compute_type.hpp"
+#include "traits/store_type.hpp"
+#include "traits/eval_cost.hpp"
 #include "operations/meta.hpp"
+#include "operations/cpu_dispatch.hpp"	// simd::cpu::inner_product
 
 #include "Vector.hpp"
 
@@ -42,14 +46,14 @@ namespace AMDiS {
   struct BufferTypeAux
   {
     typedef VectorBase<
-	MemoryBaseStatic<Value_type<E>, S, 1>, 
+	MemoryBaseStatic<traits::compute_type<Value_type<E>>, S, 1>, 
 	StaticSizePolicy<S> > type;
   };
   
   template <Expression E, int S>
   struct BufferTypeAux<E, S, false>
   {
-    typedef VectorBase< MemoryBaseDynamic<Value_type<E>, false> > type;
+    typedef VectorBase< MemoryBaseDynamic<traits::compute_type<Value_type<E>>, false> > type;
   };
   
   template <class E, bool use_buffer>
@@ -57,7 +61,28 @@ namespace AMDiS {
   using BufferType = 
       if_then_else< use_buffer, 
 		    typename BufferTypeAux<E, E::_SIZE, (E::_SIZE > 0)>::type,
-		    E const& >;
+		    traits::store_type<E> >;
+  
+  
+  /// estimated cost (in flops per element) of the allocation of a dynamic buffer
+  static constexpr int BUFFER_ALLOC_COST = 8;
+  
+  /// \brief Cost model that decides whether the vector argument \p V of a 
+  /// matrix-vector product with matrix \p M is evaluated into a buffer.
+  /** Each element of V is read num_rows(M) times. Recomputation costs 
+   *  rows*c flops per element, with c = traits::eval_cost<V>. Buffering costs
+   *  c flops plus a store, and an allocation if the size of V is dynamic.
+   *  For static sizes the buffer is a stack-allocated static vector.
+   **/
+  template <MatrixExpr M, VectorExpr V>
+  struct UseBuffer
+  {
+    static constexpr int cost = traits::eval_cost<V>::value;
+    static constexpr int reads = (M::_ROWS > 0 ? M::_ROWS : traits::COST_DYNAMIC_SIZE);
+    static constexpr int overhead = (V::_SIZE > 0 ? 1 : 1 + BUFFER_ALLOC_COST);
+    
+    static constexpr bool value = (cost > 0) && (cost * reads > cost + overhead);
+  };
 
       
   /// \brief Expression with two arguments, that multiplies a matrix_expr with a vector_expr
@@ -66,13 +91,13 @@ namespace AMDiS {
   template <MatrixExpr M, VectorExpr V, bool use_buffer>
   struct MatVecExpr
   {
-    typedef MatVecExpr                           self;
+    typedef MatVecExpr                                 self;
     
-    typedef Value_type<V>                  value_type; // TODO: use mult_type
-    typedef traits::max_size_type<M, V>     size_type;
+    typedef traits::compute_type<Value_type<V>>  value_type; // TODO: use mult_type
+    typedef traits::max_size_type<M, V>           size_type;
 	
-    typedef M                             matrix_type;
-    typedef BufferType<V, use_buffer>     vector_type;
+    typedef M                                   matrix_type;
+    typedef BufferType<V, use_buffer>           vector_type;
     
     // sizes of the resulting expr.
     static constexpr int _SIZE = M::_ROWS;
@@ -84,64 +109,70 @@ namespace AMDiS {
     
   public:
     /// constructor takes a matrix expression \p mat and a 
-    /// vector expression \p vec for the matrix-vector product.
-    MatVecExpr(matrix_type const& mat, vector_type const& vec) 
+    /// vector expression \p vec for the matrix-vector product. The buffer
+    /// is evaluated in place from \p vec.
+    constexpr MatVecExpr(matrix_type const& mat, V const& vec) 
 	: matrix(mat), vector(vec)
     { 
-      TEST_EXIT_DBG( num_cols(mat) == num_rows(vec) )("Sizes do not match!\n");
+      TEST_EXIT_DBG_CONSTEXPR( num_cols(mat) == num_rows(vec) )("Sizes do not match!\n");
     }
     
     /// access the elements of an expr.
-    inline value_type operator()(size_type i) const
+    constexpr value_type operator()(size_type i) const
     {
       return reduce(i, int_<ARG_COLS>());
     }
     
-    matrix_type const& get_matrix() const { return matrix; }
-    vector_type const& get_vector() const { return vector; }
+    constexpr matrix_type const& get_matrix() const { return matrix; }
+    constexpr vector_type const& get_vector() const { return vector; }
     
   protected:  
+    // static size: unrolled inner product
     template <int N> requires (N > 0)
-    inline value_type reduce(size_type row, int_<N>) const
+    constexpr value_type reduce(size_type row, int_<N>) const
     {
       using meta::FOR;
-      value_type erg = math::zero(value_type());
+      typedef functors::dot_real_functor<value_type, value_type> F;
+      value_type erg{};
+      F::init(erg);
       FOR<0,N>::inner_product([row, this](size_type col) { return this->matrix(row, col); }, 
-			      vector, erg, functors::dot_functor<value_type, value_type>());
+			      vector, erg, F());
       return erg;
     }
     
+    // dynamic size: kernel for the instruction set of the cpu
     inline value_type reduce(size_type r, int_<-1>) const
     {
-      value_type erg = math::zero(value_type());	  
-      for (size_type c = 0; c < num_cols(matrix); ++c)
-	erg += matrix(r,c) * vector(c);
+      value_type erg;
+      simd::cpu::inner_product([r, this](size_type col) { return this->matrix(r, col); }, 
+			       vector, num_cols(matrix), erg, 
+			       functors::dot_real_functor<value_type, value_type>());
       return erg;
     }
     
   private:
-    matrix_type const&  matrix;
-    vector_type vector;
+    traits::store_type<M>  matrix;
+    vector_type            vector;
   };
   
   
   /// Size of MatVecExpr
   template <class E1, class E2, bool b>
-  size_t size(MatVecExpr<E1,E2,b> const& expr)
+  constexpr size_t size(MatVecExpr<E1,E2,b> const& expr)
   {
     return num_rows(expr.get_matrix());
   }
   
   /// number of rows of MatVecExpr
   template <class E1, class E2, bool b>
-  size_t num_rows(MatVecExpr<E1,E2,b> const& expr)
+  constexpr size_t num_rows(MatVecExpr<E1,E2,b> const& expr)
   {
     return num_rows(expr.get_matrix());
   }
   
   /// number of columns of MatVecExpr
   template <class E1, class E2, bool b>
-  size_t num_cols(MatVecExpr<E1,E2,b> const& expr)
+  constexpr size_t num_cols(MatVecExpr<E1,E2,b> const& expr)
   {
     return 1;
   }
@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file outer_expr.hpp */
+
+#pragma once
+
+#include "traits/concepts.hpp"
+#include "traits/size.hpp"
+#include "traits/num_rows.hpp"
+#include "traits/num_cols.hpp"
+#include "traits/base_expr.hpp"
+#include "traits/compute_type.hpp"
+#include "traits/mult_type.hpp"
+#include "traits/store_type.hpp"
+#include "expressions/binary_expr.hpp"	// aux::EvalBuffer
+
+namespace AMDiS {
+
+  /// \brief Expression with two vector arguments, that represents the 
+  /// outer product (tensor product) v w^T as matrix.
+  /** Element access via operator()(i,j) returns v(i)*w(j). Assignment of the
+   *  product to a matrix uses \ref assign_to, that evaluates both vectors 
+   *  only once and applies a rank-1 update to the target, i.e. 
+   *  M += a*outer(v,w) does not create a temporary matrix.
+   **/
+  template <VectorExpr V, VectorExpr W>
+  struct OuterExpr
+  {
+    typedef OuterExpr                                             self;
+    
+    typedef traits::mult_type< traits::compute_type<Value_type<V>>, 
+			       traits::compute_type<Value_type<W>> > value_type;
+    typedef traits::max_size_type<V, W>                       size_type;
+    
+    typedef V                                                expr1_type;
+    typedef W                                                expr2_type;
+    
+    // sizes of the resulting expr.
+    static constexpr int _ROWS = V::_SIZE;
+    static constexpr int _COLS = W::_SIZE;
+    static constexpr int _SIZE = (_ROWS > 0 && _COLS > 0 ? _ROWS * _COLS : -1);
+    
+  public:
+    /// constructor takes two vector expressions \p v and \p w for the 
+    /// outer product v w^T.
+    constexpr OuterExpr(expr1_type const& v, expr2_type const& w) 
+	: expr1(v), expr2(w)
+    { }
+    
+    /// access the elements of a matrix-expr.
+    constexpr value_type operator()(size_type i, size_type j) const
+    {
+      return expr1(i) * expr2(j);
+    }
+    
+    /// access the elements of an expr. (row-major, contiguous index)
+    constexpr value_type operator()(size_type i) const
+    {
+      size_type c = size_type(size(expr2));
+      return expr1(size_type(i / c)) * expr2(size_type(i % c));
+    }
+    
+    /// \brief rank-1 update of \p target using the compound assignment 
+    /// given by \p Assigner: target (op)= v w^T
+    /** The arguments are evaluated once into local buffers before the target
+     *  is written, thus aliasing is not an issue.
+     **/
+    template <class Target, class Assigner>
+    void assign_to(Target& target, Assigner) const
+    {
+      aux::EvalBuffer<traits::compute_type<Value_type<V>>, V::_SIZE> const v(expr1);
+      aux::EvalBuffer<traits::compute_type<Value_type<W>>, W::_SIZE> const w(expr2);
+      
+      for (size_t i = 0; i < size(v); ++i) {
+	value_type const a = v(i);
+	for (size_t j = 0; j < size(w); ++j)
+	  Assigner::apply(target(size_type(i), size_type(j)), a * w(j));
+      }
+    }
+    
+    constexpr expr1_type const& get_first() const { return expr1; }
+    constexpr expr2_type const& get_second() const { return expr2; }
+    
+  private:
+    traits::store_type<V>  expr1;
+    traits::store_type<W>  expr2;
+  };
+  
+  
+  /// Size of OuterExpr
+  template <class V, class W>
+  constexpr size_t size(OuterExpr<V,W> const& expr)
+  {
+    return size(expr.get_first()) * size(expr.get_second());
+  }
+  
+  /// number of rows of OuterExpr
+  template <class V, class W>
+  constexpr size_t num_rows(OuterExpr<V,W> const& expr)
+  {
+    return size(expr.get_first());
+  }
+  
+  /// number of columns of OuterExpr
+  template <class V, class W>
+  constexpr size_t num_cols(OuterExpr<V,W> const& expr)
+  {
+    return size(expr.get_second());
+  }
+  
+} // end namespace AMDiS
@@ -24,8 +24,18 @@
 
 #pragma once
 
+#include "Log.h"			// TEST_EXIT_DBG_CONSTEXPR
+
 #include "traits/concepts.hpp"
 #include "traits/base_expr.hpp" // for base_expr
+#include "traits/compute_type.hpp"
+#include "traits/store_type.hpp"
+#include "operations/generic_loops.hpp"	// meta::TREE
+#include "operations/packet.hpp"		// simd::Packet_access
+#include "operations/cpu_dispatch.hpp"	// simd::cpu
+#include "operations/parallel.hpp"	// parallel::reduce
+#include "operations/compensated.hpp"	// simd::COMPENSATED
+#include "utility/half_float.hpp"	// Half_storage, ConvertedBlock
 
 namespace AMDiS {
 
@@ -36,10 +46,11 @@ namespace AMDiS {
   {
     typedef ReductionBinaryExpr                self;
     
-    typedef Result_type<F>               value_type;
-    typedef traits::max_size_type<E1,E2>  size_type;
-    typedef E1                           expr1_type;
-    typedef E2                           expr2_type;
+    typedef Result_type<F>                value_type;
+    typedef Accumulator_type<F>     accumulator_type;
+    typedef traits::max_size_type<E1,E2>   size_type;
+    typedef E1                            expr1_type;
+    typedef E2                            expr2_type;
     
     static constexpr int _SIZE = 1;
     static constexpr int _ROWS = 1;
@@ -50,68 +61,121 @@ namespace AMDiS {
     
   public:
     /// constructor takes two expression \p A and \p B.
-    ReductionBinaryExpr(expr1_type const& A, expr2_type const& B) 
+    constexpr ReductionBinaryExpr(expr1_type const& A, expr2_type const& B) 
 	: expr1(A), expr2(B)
     { 
-      TEST_EXIT_DBG( size(A) == size(B) )("Sizes do not match!\n");
+      TEST_EXIT_DBG_CONSTEXPR( size(A) == size(B) )("Sizes do not match!\n");
     }
     
     /// access the elements of an expr.
-    inline value_type operator()(size_type = 0, size_type = 0) const
+    constexpr value_type operator()(size_type = 0, size_type = 0) const
     {
       return reduce(int_<ARG_SIZE>());
     }
     
     /// cast operator for assignment to scalar.
-    operator value_type() const
+    constexpr operator value_type() const
     {
       return reduce(int_<ARG_SIZE>());
     }
     
-    expr1_type const& get_first() const { return expr1; }
-    expr2_type const& get_second() const { return expr2; }
+    constexpr expr1_type const& get_first() const { return expr1; }
+    constexpr expr2_type const& get_second() const { return expr2; }
     
   protected:
-    template <int N>
-    inline value_type reduce(int_<N>) const
+    // static size: unrolled, pairwise combination of partial results
+    template <int N> requires (N > 0)
+    constexpr value_type reduce(int_<N>) const
     {
-      using meta::FOR;
-      value_type erg; F::init(erg);
-      for (size_type i = 0; i < N; ++i)
-	F::update(erg, expr1(i), expr2(i));
-//       FOR<0,N>::inner_product(expr1, expr2, erg, F());
+      using meta::TREE;
+      accumulator_type erg{};
+      TREE<0,N>::inner_product(expr1, expr2, erg, F());
       return F::post_reduction(erg);
     }
     
+    // dynamic size: chunks of the expressions, see parallel::reduce
     inline value_type reduce(int_<-1>) const
     {
-      value_type erg; F::init(erg);
-      for (size_type i = 0; i < size(expr1); ++i)
-	F::update(erg, expr1(i), expr2(i));
+      size_t const n = size(expr1);
+#if PARALLEL_REDUCTION
+      if (n > REDUCTION_CHUNK_SIZE) {
+	typedef traits::aux::elementwise_cost<2, E1, E2> cost;
+	accumulator_type erg = parallel::reduce<cost, accumulator_type>(n, 
+	  [this](size_t begin, size_t end, accumulator_type& result) {
+	    inner_product(parallel::shifted(expr1, begin), parallel::shifted(expr2, begin), 
+			  end - begin, result);
+	  }, F());
+	return F::post_reduction(erg);
+      }
+#endif
+      accumulator_type erg;
+      inner_product(expr1, expr2, n, erg);
       return F::post_reduction(erg);
     }
     
+    // several independent accumulators, or SIMD packets of accumulators, 
+    // with the kernel for the instruction set of the cpu
+    template <class A, class B>
+    static void inner_product(A const& a, B const& b, size_t n, accumulator_type& erg)
+    {
+      simd::cpu::inner_product(a, b, n, erg, F());
+    }
+    
+    // two containers of 16-bit values: blocks converted to float by the bulk
+    // conversion, that are accumulated by SIMD packets
+    template <class A, class B>
+      requires Half_storage<Value_type<A>> && Half_storage<Value_type<B>> 
+	    && requires(A const& a, B const& b) { a.data(); b.data(); }
+    static void inner_product(A const& a, B const& b, size_t n, accumulator_type& erg)
+    {
+      ConvertedBlock<Value_type<B>> block_b;
+      F::init(erg);
+      for_converted_blocks(a.data(), n, [&](auto const& block_a, size_t begin, size_t m) {
+	block_b.load(b.data() + begin, m);
+	accumulator_type part;
+	simd::cpu::inner_product(block_a, block_b, m, part, F());
+	F::finish(erg, part);
+      });
+    }
+    
+    // compensated summation: 4 SIMD packets of sums and rounding errors
+    template <class A, class B>
+      requires simd::Packet_access<A, Value_type<E1>> && simd::Packet_access<B, Value_type<E1>> 
+	    && Compensated_sfunctor<F, Value_type<E1>>
+    static void inner_product(A const& a, B const& b, size_t n, accumulator_type& erg)
+    {
+      simd::COMPENSATED<4>::inner_product(a, b, n, erg, F());
+    }
+    
   private:
-    expr1_type const& expr1;
-    expr2_type const& expr2;
+    traits::store_type<E1> expr1;
+    traits::store_type<E2> expr2;
   };
   
   /// Size of ReductionBinaryExpr
   template <class E1, class E2, class F>
-  size_t size(ReductionBinaryExpr<E1,E2,F> const&) { return 1; }
+  constexpr size_t size(ReductionBinaryExpr<E1,E2,F> const&) { return 1; }
   
   /// Size of ReductionBinaryExpr
   template <class E1, class E2, class F>
-  size_t num_rows(ReductionBinaryExpr<E1,E2,F> const&) { return 1; }
+  constexpr size_t num_rows(ReductionBinaryExpr<E1,E2,F> const&) { return 1; }
   
   /// Size of ReductionBinaryExpr
   template <class E1, class E2, class F>
-  size_t num_cols(ReductionBinaryExpr<E1,E2,F> const&) { return 1; }
+  constexpr size_t num_cols(ReductionBinaryExpr<E1,E2,F> const&) { return 1; }
   
   // standard inner product
   template <Expression E1, Expression E2>
   using DotExpr =
     ReductionBinaryExpr<E1, E2, 
-	      functors::dot_functor<Value_type<E1>, Value_type<E2> > >;
+	      functors::dot_functor<traits::compute_type<Value_type<E1>>, 
+				  traits::compute_type<Value_type<E2>> > >;
+  
+  // inner product of real vectors, compensated
+  template <Expression E1, Expression E2>
+  using CompensatedDotExpr =
+    ReductionBinaryExpr<E1, E2, 
+	      functors::compensated_dot_functor<traits::compute_type<Value_type<E1>>, 
+						traits::compute_type<Value_type<E2>> > >;
   
 } // end namespace AMDiS
@@ -27,7 +27,15 @@
 
 #include "traits/concepts.hpp"
 #include "traits/base_expr.hpp" // for base_expr
+#include "traits/compute_type.hpp"
+#include "traits/store_type.hpp"
+#include "operations/generic_loops.hpp"	// meta::TREE
+#include "operations/packet.hpp"		// simd::Packet_access
+#include "operations/cpu_dispatch.hpp"	// simd::cpu
+#include "operations/parallel.hpp"	// parallel::reduce
 #include "operations/reduction_functors.hpp"
+#include "operations/compensated.hpp"	// simd::COMPENSATED
+#include "utility/half_float.hpp"	// Half_storage, for_converted_blocks
 
 namespace AMDiS {
 
@@ -38,9 +46,10 @@ namespace AMDiS {
   {
     typedef ReductionUnaryExpr        self;
     
-    typedef Result_type<F>      value_type;
-    typedef Size_type<E>         size_type;
-    typedef E                    expr_type;
+    typedef Result_type<F>            value_type;
+    typedef Accumulator_type<F>  accumulator_type;
+    typedef Size_type<E>               size_type;
+    typedef E                          expr_type;
     
     static constexpr int _SIZE = 1;
     static constexpr int _ROWS = 1;
@@ -51,106 +60,169 @@ namespace AMDiS {
     
   public:
     /// constructor takes on expression \p A.
-    ReductionUnaryExpr(expr_type const& A) 
+    constexpr ReductionUnaryExpr(expr_type const& A) 
       : expr(A)
     { }
     
     /// access the elements of an expr.
-    inline value_type operator()(size_type = 0, size_type = 0) const
+    constexpr value_type operator()(size_type = 0, size_type = 0) const
     {
       return reduce(int_<ARG_SIZE>()) ;
     }
     
     /// cast operator for assignment to scalar.
-    operator value_type() const
+    constexpr operator value_type() const
     {
       return reduce(int_<ARG_SIZE>());
     }
     
-    expr_type const& get_first() const { return expr; }
+    constexpr expr_type const& get_first() const { return expr; }
     
   protected:
-    template <int N>
-    inline value_type reduce(int_<N>) const
+    // static size: unrolled, pairwise combination of partial results
+    template <int N> requires (N > 0)
+    constexpr value_type reduce(int_<N>) const
     {
-      using meta::FOR;
-      value_type erg; F::init(erg);
-      
-      for (size_type i = 0; i < size(expr); ++i)
-	F::update(erg, expr(i));
-      
-//       FOR<0,N>::accumulate(expr, erg, F());
+      using meta::TREE;
+      accumulator_type erg{};
+      TREE<0,N>::accumulate(expr, erg, F());
       return F::post_reduction(erg);
     }
     
+    // dynamic size: chunks of the expression, see parallel::reduce
     inline value_type reduce(int_<-1>) const
     {
-      value_type erg; F::init(erg);
-      for (size_type i = 0; i < size(expr); ++i)
-	F::update(erg, expr(i));
+      size_t const n = size(expr);
+#if PARALLEL_REDUCTION
+      if (n > REDUCTION_CHUNK_SIZE) {
+	typedef traits::aux::elementwise_cost<1, E> cost;
+	accumulator_type erg = parallel::reduce<cost, accumulator_type>(n, 
+	  [this](size_t begin, size_t end, accumulator_type& result) {
+	    accumulate(parallel::shifted(expr, begin), end - begin, result);
+	  }, F());
+	return F::post_reduction(erg);
+      }
+#endif
+      accumulator_type erg;
+      accumulate(expr, n, erg);
       return F::post_reduction(erg);
     }
     
+    // several independent accumulators, or SIMD packets of accumulators, 
+    // with the kernel for the instruction set of the cpu
+    template <class A>
+    static void accumulate(A const& a, size_t n, accumulator_type& erg)
+    {
+      simd::cpu::accumulate(a, n, erg, F());
+    }
+    
+    // containers of 16-bit values: blocks converted to float by the bulk 
+    // conversion, that are accumulated by SIMD packets
+    template <class A>
+      requires Half_storage<Value_type<A>> && requires(A const& a) { a.data(); }
+    static void accumulate(A const& a, size_t n, accumulator_type& erg)
+    {
+      F::init(erg);
+      for_converted_blocks(a.data(), n, [&erg](auto const& block, size_t, size_t m) {
+	accumulator_type part;
+	simd::cpu::accumulate(block, m, part, F());
+	F::finish(erg, part);
+      });
+    }
+    
+    // compensated summation: 4 SIMD packets of sums and rounding errors
+    template <class A>
+      requires simd::Packet_access<A, Value_type<E>> && Compensated_sfunctor<F, Value_type<E>>
+    static void accumulate(A const& a, size_t n, accumulator_type& erg)
+    {
+      simd::COMPENSATED<4>::accumulate(a, n, erg, F());
+    }
+    
   private:
-    expr_type const& expr;
+    traits::store_type<E> expr;
   };
   
   /// Size of ReductionUnaryExpr
   template <class E, class F>
-  size_t size(ReductionUnaryExpr<E,F> const&) { return 1; }
+  constexpr size_t size(ReductionUnaryExpr<E,F> const&) { return 1; }
   
   /// Size of ReductionUnaryExpr
   template <class E, class F>
-  size_t num_rows(ReductionUnaryExpr<E,F> const&) { return 1; }
+  constexpr size_t num_rows(ReductionUnaryExpr<E,F> const&) { return 1; }
   
   /// Size of ReductionUnaryExpr
   template <class E, class F>
-  size_t num_cols(ReductionUnaryExpr<E,F> const&) { return 1; }
+  constexpr size_t num_cols(ReductionUnaryExpr<E,F> const&) { return 1; }
   
   
   // norm |V|_1
   template <Expression E>
   using OneNormExpr =
-    ReductionUnaryExpr<E, functors::one_norm_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::one_norm_functor<traits::compute_type<Value_type<E>> > >;
     
   // norm |V|_2
   template <Expression E>
   using TwoNormExpr =
-    ReductionUnaryExpr<E, functors::two_norm_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::two_norm_functor<traits::compute_type<Value_type<E>> > >;
     
   // V*V
   template <Expression E>
   using UnaryDotExpr =
-    ReductionUnaryExpr<E, functors::unary_dot_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::unary_dot_functor<traits::compute_type<Value_type<E>> > >;
     
   // max(V)
   template <Expression E>
   using MaxExpr =
-    ReductionUnaryExpr<E, functors::max_reduction_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::max_reduction_functor<traits::compute_type<Value_type<E>> > >;
     
   // abs_max(V)
   template <Expression E>
   using AbsMaxExpr =
-    ReductionUnaryExpr<E, functors::abs_max_reduction_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::abs_max_reduction_functor<traits::compute_type<Value_type<E>> > >;
     
   // min(V)
   template <Expression E>
   using MinExpr =
-    ReductionUnaryExpr<E, functors::min_reduction_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::min_reduction_functor<traits::compute_type<Value_type<E>> > >;
     
   // max(V)
   template <Expression E>
   using AbsMinExpr =
-    ReductionUnaryExpr<E, functors::abs_min_reduction_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::abs_min_reduction_functor<traits::compute_type<Value_type<E>> > >;
     
   // sum(V)
   template <Expression E>
   using SumExpr =
-    ReductionUnaryExpr<E, functors::sum_reduction_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::sum_reduction_functor<traits::compute_type<Value_type<E>> > >;
     
   // prod(V)
   template <Expression E>
   using ProdExpr =
-    ReductionUnaryExpr<E, functors::prod_reduction_functor<Value_type<E> > >;
+    ReductionUnaryExpr<E, functors::prod_reduction_functor<traits::compute_type<Value_type<E>> > >;
+    
+  // any(M)
+  template <Expression E>
+  using AnyExpr =
+    ReductionUnaryExpr<E, functors::any_reduction_functor >;
+    
+  // all(M)
+  template <Expression E>
+  using AllExpr =
+    ReductionUnaryExpr<E, functors::all_reduction_functor >;
+    
+  // count(M)
+  template <Expression E>
+  using CountExpr =
+    ReductionUnaryExpr<E, functors::count_reduction_functor<size_t> >;
+    
+  // sum(V), compensated
+  template <Expression E>
+  using CompensatedSumExpr =
+    ReductionUnaryExpr<E, functors::compensated_sum_functor<traits::compute_type<Value_type<E>> > >;
+    
+  // norm |V|_2, compensated
+  template <Expression E>
+  using CompensatedTwoNormExpr =
+    ReductionUnaryExpr<E, functors::compensated_two_norm_functor<traits::compute_type<Value_type<E>> > >;
   
 } // end namespace AMDiS
@@ -24,12 +24,14 @@
 
 #pragma once
 
-#include <boost/numeric/mtl/operation/sfunctor.hpp>
-
 #include "traits/concepts.hpp"
 #include "traits/size.hpp"
 #include "traits/num_rows.hpp"
 #include "traits/num_cols.hpp"
+#include "traits/compute_type.hpp"
+#include "traits/store_type.hpp"
+#include "operations/functors.hpp"
+#include "operations/packet.hpp"
 
 namespace AMDiS {
 
@@ -39,11 +41,11 @@ namespace AMDiS {
              (from_left==false && Binary_sfunctor<F, Value_type<E>, Value>)
   struct ScaleExprBase
   {
-    typedef ScaleExprBase            self;
+    typedef ScaleExprBase                                self;
     
-    typedef Value_type<E>      value_type;
-    typedef Size_type<E>        size_type;
-    typedef E                   expr_type;
+    typedef traits::compute_type<Value_type<E>>    value_type;
+    typedef Size_type<E>                            size_type;
+    typedef E                                       expr_type;
     
     static constexpr int _SIZE = E::_SIZE;
     static constexpr int _ROWS = E::_ROWS;
@@ -51,34 +53,61 @@ namespace AMDiS {
     
   public:
     /// constructor takes the factor \p v and and expression \p A
-    ScaleExprBase(Value v, expr_type const& A) 
+    constexpr ScaleExprBase(Value v, expr_type const& A) 
 	: value(v), expr(A) 
     { }
     
-    expr_type const& get_first() const { return expr; }
+    constexpr expr_type const& get_first() const { return expr; }
+    
+    /// the scaling factor
+    constexpr Value get_value() const { return value; }
     
     /// access the elements of an expr.
-    inline value_type operator()(size_type i) const
+    constexpr value_type operator()(size_type i) const
     { 
       return apply(i, bool_<from_left>());
     }
     
+    /// access the elements [i, i+W) of an expr. as SIMD packet.
+    template <int Bytes = SIMD_BYTES>
+    inline simd::Packet<value_type, Bytes> packet(size_type i) const
+      requires simd::Packet_access<E, value_type> && simd::packet_functor<F>::value
+    { 
+      return packet(i, bool_<from_left>(), int_<Bytes>());
+    }
+    
   private:
     // scale from left
-    inline value_type apply(size_type i, true_) const 
+    constexpr value_type apply(size_type i, true_) const 
     {
       return F::apply( value, expr(i) );
     }
     
     // scale from right
-    inline value_type apply(size_type i, false_) const 
+    constexpr value_type apply(size_type i, false_) const 
     {
       return F::apply( expr(i), value );
     }
     
+    // scale packet from left
+    template <int Bytes>
+    inline simd::Packet<value_type, Bytes> packet(size_type i, true_, int_<Bytes>) const 
+    {
+      return simd::packet_functor<F>::apply( simd::broadcast<Bytes>(value_type(value)), 
+					     expr.template packet<Bytes>(i) );
+    }
+    
+    // scale packet from right
+    template <int Bytes>
+    inline simd::Packet<value_type, Bytes> packet(size_type i, false_, int_<Bytes>) const 
+    {
+      return simd::packet_functor<F>::apply( expr.template packet<Bytes>(i), 
+					     simd::broadcast<Bytes>(value_type(value)) );
+    }
+    
   protected:
     Value value;
-    expr_type const& expr;
+    traits::store_type<E> expr;
   };
   
   
@@ -91,7 +120,7 @@ namespace AMDiS {
       : public ScaleExprBase<Value, E, from_left, F>
   {
     typedef ScaleExprBase<Value, E, from_left, F>  super;
-    ScaleExpr(Value v, E const& expr) : super(v, expr) { }
+    constexpr ScaleExpr(Value v, E const& expr) : super(v, expr) { }
   };
   
   
@@ -101,10 +130,10 @@ namespace AMDiS {
       : public ScaleExprBase<Value, E, from_left, F>
   {
     typedef ScaleExprBase<Value, E, from_left, F>  super;
-    ScaleExpr(Value v, E const& expr) : super(v, expr) { }
+    constexpr ScaleExpr(Value v, E const& expr) : super(v, expr) { }
     
     /// access the elements of a matrix-expr.
-    inline typename super::value_type 
+    constexpr typename super::value_type 
     operator()(typename super::size_type i, typename super::size_type j) const
     { 
       return apply(i, j, bool_<from_left>());
@@ -113,14 +142,14 @@ namespace AMDiS {
     
   private:
     // scale from left
-    inline typename super::value_type 
+    constexpr typename super::value_type 
     apply(typename super::size_type i, typename super::size_type j, true_) const 
     {
       return F::apply( super::value, super::expr(i,j) );
     }
     
     // scale from right
-    inline typename super::value_type 
+    constexpr typename super::value_type 
     apply(typename super::size_type i, typename super::size_type j, false_) const 
     {
       return F::apply( super::expr(i,j), super::value );
@@ -130,21 +159,21 @@ namespace AMDiS {
   
   /// Size of ScaleExpr
   template <class V, class E, bool l, class F>
-  size_t size(ScaleExpr<V, E, l, F> const& expr)
+  constexpr size_t size(ScaleExpr<V, E, l, F> const& expr)
   {
     return size(expr.get_first());
   }
   
   /// Size of ScaleExpr
   template <class V, class E, bool l, class F>
-  size_t num_rows(ScaleExpr<V, E, l, F> const& expr)
+  constexpr size_t num_rows(ScaleExpr<V, E, l, F> const& expr)
   {
     return num_rows(expr.get_first());
   }
   
   /// Size of ScaleExpr
   template <class V, class E, bool l, class F>
-  size_t num_cols(ScaleExpr<V, E, l, F> const& expr)
+  constexpr size_t num_cols(ScaleExpr<V, E, l, F> const& expr)
   {
     return num_cols(expr.get_first());
   }
@@ -153,18 +182,18 @@ namespace AMDiS {
   template <Arithmetic Value, Expression E>
     requires concepts::Multiplicable<Value, Value_type<E>>
   using LeftScaleExpr =
-    ScaleExpr<Value, E, true, mtl::sfunctor::times<Value_type<E>, Value>>;
+    ScaleExpr<Value, E, true, functors::times<Value, Value_type<E>>>;
     
   // V * s
   template <Arithmetic Value, Expression E>
     requires concepts::Multiplicable<Value_type<E>, Value>
   using RightScaleExpr =
-    ScaleExpr<Value, E, false, mtl::sfunctor::times<Value_type<E>, Value>>;
+    ScaleExpr<Value, E, false, functors::times<Value_type<E>, Value>>;
   
   // V / s
   template <Arithmetic Value, Expression E>
     requires concepts::Divisible<Value_type<E>, Value>
   using RightDivideExpr =
-    ScaleExpr<Value, E, false, mtl::sfunctor::divide<Value_type<E>, Value>>;
+    ScaleExpr<Value, E, false, functors::divide<Value_type<E>, Value>>;
   
 } // end namespace AMDiS
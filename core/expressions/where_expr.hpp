@@ -0,0 +1,392 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file where_expr.hpp */
+
+#pragma once
+
+#include "Log.h"			// TEST_EXIT_DBG_CONSTEXPR
+#include <type_traits>
+
+#include "traits/concepts.hpp"
+#include "traits/size.hpp"
+#include "traits/num_rows.hpp"
+#include "traits/num_cols.hpp"
+#include "traits/store_type.hpp"
+#include "operations/functors.hpp"
+#include "operations/packet.hpp"
+
+#include "traits/base_expr.hpp" // for ShapedExpr
+
+namespace AMDiS {
+
+  /// \brief operands of comparisons and selections: expressions, or scalars 
+  /// that are broadcasted to all elements. At least one operand must be an 
+  /// expression, that determines the shape.
+  template <class A, class B>
+  concept bool Elementwise_operands = 
+    (Expression<A> && (Expression<B> || Arithmetic<B>)) || (Arithmetic<A> && Expression<B>);
+  
+  
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    // properties of a scalar operand
+    template <class X>
+    struct operand_traits
+    {
+      typedef X value_type;
+      
+      static constexpr int _SIZE = -1;
+      static constexpr int _ROWS = -1;
+      static constexpr int _COLS = -1;
+    };
+    
+    // properties of an expression operand
+    template <Expression E>
+    struct operand_traits<E>
+    {
+      typedef Value_type<E> value_type;
+      
+      static constexpr int _SIZE = E::_SIZE;
+      static constexpr int _ROWS = E::_ROWS;
+      static constexpr int _COLS = E::_COLS;
+    };
+    
+    template <class X>
+    using operand_value_type = typename operand_traits<X>::value_type;
+    
+    // the operand, that determines the shape
+    template <class A, class B>
+    using shape_type = if_then_else< Expression<A>, A, B >;
+    
+    template <Expression A, class B>
+    constexpr A const& shape_of(A const& a, B const&) { return a; }
+    
+    template <Arithmetic A, Expression B>
+    constexpr B const& shape_of(A const&, B const& b) { return b; }
+    
+    // sizes must match, if both operands are expressions
+    template <class A, class B>
+    constexpr bool same_size(A const&, B const&) { return true; }
+    
+    template <Expression A, Expression B>
+    constexpr bool same_size(A const& a, B const& b) { return size(a) == size(b); }
+    
+    // element i (or (i,j)) of an operand
+    template <Expression E, class I>
+    constexpr Value_type<E> element(E const& expr, I i) { return expr(i); }
+    
+    template <Arithmetic T, class I>
+    constexpr T element(T const& value, I) { return value; }
+    
+    template <MatrixExpr E, class I>
+    constexpr Value_type<E> element(E const& expr, I i, I j) { return expr(i, j); }
+    
+    template <Arithmetic T, class I>
+    constexpr T element(T const& value, I, I) { return value; }
+    
+    // elements [i, i+W) of an operand as packet of type T
+    template <class T, int Bytes, Expression E, class I>
+    inline simd::Packet<T, Bytes> element_packet(E const& expr, I i) { return expr.template packet<Bytes>(i); }
+    
+    template <class T, int Bytes, Arithmetic S, class I>
+    inline simd::Packet<T, Bytes> element_packet(S const& value, I) { return simd::broadcast<Bytes>(T(value)); }
+    
+  } // end namespace aux
+  
+  namespace simd
+  {
+    // operands with packet access of type T. Scalars are broadcasted.
+    template <class X, class T>
+    concept bool Packet_operand = 
+      Packet_access<X, T> || (Arithmetic<X> && (packet_traits<T>::size > 1));
+  }
+  /// \endcond
+  
+  
+  /// \brief Elementwise comparison of two operands, that results in a mask 
+  /// with value type bool.
+  /** If both operands have packet access, mask(i) provides the comparison 
+   *  of the elements [i, i+W) as simd::Mask, that is used by \ref WhereExpr
+   *  to blend packets.
+   **/
+  template <class A, class B, class F>
+    requires Elementwise_operands<A, B> && 
+	     Binary_sfunctor<F, aux::operand_value_type<A>, aux::operand_value_type<B>>
+  struct CompareExprBase
+  {
+    typedef CompareExprBase                                 self;
+    typedef aux::shape_type<A, B>                     shape_type;
+    
+    typedef bool                                      value_type;
+    typedef Size_type<shape_type>                      size_type;
+    typedef A                                         expr1_type;
+    typedef B                                         expr2_type;
+    
+    /// type the operands are compared in
+    typedef std::common_type_t<aux::operand_value_type<A>, 
+			       aux::operand_value_type<B>> compare_type;
+    
+    static constexpr int _SIZE = max(aux::operand_traits<A>::_SIZE, aux::operand_traits<B>::_SIZE);
+    static constexpr int _ROWS = max(aux::operand_traits<A>::_ROWS, aux::operand_traits<B>::_ROWS);
+    static constexpr int _COLS = max(aux::operand_traits<A>::_COLS, aux::operand_traits<B>::_COLS);
+    
+    /// constructor takes the two operands
+    constexpr CompareExprBase(expr1_type const& a, expr2_type const& b) 
+	: expr1(a), expr2(b) 
+    { 
+      TEST_EXIT_DBG_CONSTEXPR( aux::same_size(a, b) )("Sizes do not match!\n");
+    }
+    
+    /// access the elements of an expr.
+    constexpr value_type operator()(size_type i) const
+    { 
+      return F::apply( aux::element(expr1, i), aux::element(expr2, i) );
+    }
+    
+    /// access the comparison of the elements [i, i+W) as SIMD mask.
+    template <int Bytes = SIMD_BYTES>
+    inline simd::Mask<compare_type, Bytes> mask(size_type i) const
+      requires simd::Packet_operand<A, compare_type> && 
+	       simd::Packet_operand<B, compare_type> && simd::packet_functor<F>::value
+    { 
+      return simd::packet_functor<F>::apply( aux::element_packet<compare_type, Bytes>(expr1, i), 
+					     aux::element_packet<compare_type, Bytes>(expr2, i) );
+    }
+    
+    constexpr expr1_type const& get_first() const { return expr1; }
+    constexpr expr2_type const& get_second() const { return expr2; }
+    
+  protected:
+    traits::store_type<A> expr1;
+    traits::store_type<B> expr2;
+  };
+  
+  
+  template <class A, class B, class F>
+  struct CompareExpr {};
+  
+  
+  // elementwise vector comparison
+  template <class A, class B, class F>
+    requires VectorExpr<aux::shape_type<A, B>>
+  struct CompareExpr<A, B, F>
+    : public CompareExprBase<A, B, F>
+  {
+    typedef CompareExprBase<A, B, F>  super;
+    constexpr CompareExpr(A const& a, B const& b) : super(a, b) { }
+  };
+  
+  
+  // elementwise matrix comparison
+  template <class A, class B, class F>
+    requires MatrixExpr<aux::shape_type<A, B>>
+  struct CompareExpr<A, B, F>
+    : public CompareExprBase<A, B, F>
+  {
+    typedef CompareExprBase<A, B, F>  super;
+    constexpr CompareExpr(A const& a, B const& b) : super(a, b) { }
+    
+    /// access the elements of a matrix-expr.
+    constexpr typename super::value_type 
+    operator()(typename super::size_type i, typename super::size_type j) const
+    { 
+      return F::apply( aux::element(super::expr1, i, j), aux::element(super::expr2, i, j) );
+    }
+    using super::operator();
+  };
+  
+  
+  /// Size of CompareExpr
+  template <class A, class B, class F>
+  constexpr size_t size(CompareExpr<A, B, F> const& expr)
+  {
+    return size(aux::shape_of(expr.get_first(), expr.get_second()));
+  }
+  
+  /// number of rows of CompareExpr
+  template <class A, class B, class F>
+  constexpr size_t num_rows(CompareExpr<A, B, F> const& expr)
+  {
+    return num_rows(aux::shape_of(expr.get_first(), expr.get_second()));
+  }
+  
+  /// number of columns of CompareExpr
+  template <class A, class B, class F>
+  constexpr size_t num_cols(CompareExpr<A, B, F> const& expr)
+  {
+    return num_cols(aux::shape_of(expr.get_first(), expr.get_second()));
+  }
+  
+  
+  // ===========================================================================
+  
+  
+  /// \brief Elementwise selection (mask(i) ? a(i) : b(i)) of two operands.
+  /** Both operands are evaluated for all elements, like a blend of SIMD 
+   *  registers, so there is no branch in the loop. If the mask is a 
+   *  comparison with packet access and both operands have packet access, 
+   *  packet(i) blends the packets of the operands.
+   **/
+  template <Expression M, class A, class B>
+    requires std::is_same<Value_type<M>, bool>::value && 
+	     (Expression<A> || Arithmetic<A>) && (Expression<B> || Arithmetic<B>)
+  struct WhereExprBase
+  {
+    typedef WhereExprBase                                   self;
+    
+    typedef std::common_type_t<aux::operand_value_type<A>, 
+			       aux::operand_value_type<B>>  value_type;
+    typedef Size_type<M>                                     size_type;
+    typedef M                                                mask_type;
+    typedef A                                               expr1_type;
+    typedef B                                               expr2_type;
+    
+    static constexpr int _SIZE = max(M::_SIZE, max(aux::operand_traits<A>::_SIZE, aux::operand_traits<B>::_SIZE));
+    static constexpr int _ROWS = max(M::_ROWS, max(aux::operand_traits<A>::_ROWS, aux::operand_traits<B>::_ROWS));
+    static constexpr int _COLS = max(M::_COLS, max(aux::operand_traits<A>::_COLS, aux::operand_traits<B>::_COLS));
+    
+    /// constructor takes the mask \p m and the two operands \p a and \p b
+    constexpr WhereExprBase(mask_type const& m, expr1_type const& a, expr2_type const& b) 
+	: mask(m), expr1(a), expr2(b) 
+    { 
+      TEST_EXIT_DBG_CONSTEXPR( aux::same_size(m, a) && aux::same_size(m, b) )("Sizes do not match!\n");
+    }
+    
+    /// access the elements of an expr.
+    constexpr value_type operator()(size_type i) const
+    { 
+      value_type const a = aux::element(expr1, i);
+      value_type const b = aux::element(expr2, i);
+      return mask(i) ? a : b;
+    }
+    
+    /// access the elements [i, i+W) of an expr. as SIMD packet.
+    template <int Bytes = SIMD_BYTES>
+    inline simd::Packet<value_type, Bytes> packet(size_type i) const
+      requires simd::Mask_access<M, value_type> && 
+	       simd::Packet_operand<A, value_type> && simd::Packet_operand<B, value_type>
+    { 
+      return simd::select( mask.template mask<Bytes>(i), 
+			   aux::element_packet<value_type, Bytes>(expr1, i), 
+			   aux::element_packet<value_type, Bytes>(expr2, i) );
+    }
+    
+    constexpr mask_type const& get_mask() const { return mask; }
+    constexpr expr1_type const& get_first() const { return expr1; }
+    constexpr expr2_type const& get_second() const { return expr2; }
+    
+  protected:
+    traits::store_type<M> mask;
+    traits::store_type<A> expr1;
+    traits::store_type<B> expr2;
+  };
+  
+  
+  template <Expression M, class A, class B>
+  struct WhereExpr {};
+  
+  
+  // elementwise vector selection
+  template <VectorExpr M, class A, class B>
+  struct WhereExpr<M, A, B>
+    : public WhereExprBase<M, A, B>
+  {
+    typedef WhereExprBase<M, A, B>  super;
+    constexpr WhereExpr(M const& m, A const& a, B const& b) : super(m, a, b) { }
+  };
+  
+  
+  // elementwise matrix selection
+  template <MatrixExpr M, class A, class B>
+  struct WhereExpr<M, A, B>
+    : public WhereExprBase<M, A, B>
+  {
+    typedef WhereExprBase<M, A, B>  super;
+    constexpr WhereExpr(M const& m, A const& a, B const& b) : super(m, a, b) { }
+    
+    /// access the elements of a matrix-expr.
+    constexpr typename super::value_type 
+    operator()(typename super::size_type i, typename super::size_type j) const
+    { 
+      typename super::value_type const a = aux::element(super::expr1, i, j);
+      typename super::value_type const b = aux::element(super::expr2, i, j);
+      return super::mask(i, j) ? a : b;
+    }
+    using super::operator();
+  };
+  
+  
+  /// Size of WhereExpr
+  template <class M, class A, class B>
+  constexpr size_t size(WhereExpr<M, A, B> const& expr)
+  {
+    return size(expr.get_mask());
+  }
+  
+  /// number of rows of WhereExpr
+  template <class M, class A, class B>
+  constexpr size_t num_rows(WhereExpr<M, A, B> const& expr)
+  {
+    return num_rows(expr.get_mask());
+  }
+  
+  /// number of columns of WhereExpr
+  template <class M, class A, class B>
+  constexpr size_t num_cols(WhereExpr<M, A, B> const& expr)
+  {
+    return num_cols(expr.get_mask());
+  }
+  
+  
+  // A < B
+  template <class A, class B>
+  using LessExpr = 
+    CompareExpr<A, B, functors::less<aux::operand_value_type<A>, aux::operand_value_type<B>> >;
+  
+  // A <= B
+  template <class A, class B>
+  using LessEqualExpr = 
+    CompareExpr<A, B, functors::less_equal<aux::operand_value_type<A>, aux::operand_value_type<B>> >;
+  
+  // A > B
+  template <class A, class B>
+  using GreaterExpr = 
+    CompareExpr<A, B, functors::greater<aux::operand_value_type<A>, aux::operand_value_type<B>> >;
+  
+  // A >= B
+  template <class A, class B>
+  using GreaterEqualExpr = 
+    CompareExpr<A, B, functors::greater_equal<aux::operand_value_type<A>, aux::operand_value_type<B>> >;
+  
+  // A == B
+  template <class A, class B>
+  using EqualExpr = 
+    CompareExpr<A, B, functors::equal_to<aux::operand_value_type<A>, aux::operand_value_type<B>> >;
+  
+  // A != B
+  template <class A, class B>
+  using NotEqualExpr = 
+    CompareExpr<A, B, functors::not_equal_to<aux::operand_value_type<A>, aux::operand_value_type<B>> >;
+  
+} // end namespace AMDiS
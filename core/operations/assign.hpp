@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>	// std::numeric_limits
+
 namespace AMDiS {
   namespace assign {
     
@@ -11,9 +13,9 @@ namespace AMDiS {
     struct value
     {
       typedef T result_type;
-      value(S val = 0) : val(val) {}
+      constexpr value(S val = 0) : val(val) {}
       
-      T& operator()(T& v) const { return (v = val); }
+      constexpr T& operator()(T& v) const { return (v = val); }
       
     private:
       S val;
@@ -23,19 +25,20 @@ namespace AMDiS {
     template <class T, class S, S Val>
     struct ct_value : value<T, S>
     {
-      ct_value() : value<T, S>(Val) {}
+      constexpr ct_value() : value<T, S>(Val) {}
     };
     
+    /// assign_lowest(v) --> v = lowest value of S, i.e. -max for floating points
     template <class T, class S=T>
     struct min_value : value<T, S>
     {
-      min_value() : value<T, S>(std::numeric_limits<S>::min()) {}
+      constexpr min_value() : value<T, S>(std::numeric_limits<S>::lowest()) {}
     };
     
     template <class T, class S=T>
     struct max_value : value<T, S>
     {
-      max_value() : value<T, S>(std::numeric_limits<S>::max()) {}
+      constexpr max_value() : value<T, S>(std::numeric_limits<S>::max()) {}
     };
     
     /// add_constant(v) --> v += value
@@ -100,8 +103,8 @@ namespace AMDiS {
     {
       typedef T result_type;
       
-      static T& apply(T& v, T const& v0) { return (v = v0); }
-      T& operator()(T& v, T const& v0) const { return (v = v0); }
+      static constexpr T& apply(T& v, T const& v0) { return (v = v0); }
+      constexpr T& operator()(T& v, T const& v0) const { return (v = v0); }
     };
 
     /// functor for operator+=
@@ -110,8 +113,8 @@ namespace AMDiS {
     {
       typedef T result_type;
       
-      static T& apply(T& v, T const& v0) { return (v += v0); }
-      T& operator()(T& v, T const& v0) const { return (v += v0); }
+      static constexpr T& apply(T& v, T const& v0) { return (v += v0); }
+      constexpr T& operator()(T& v, T const& v0) const { return (v += v0); }
     };
 
     /// functor for operator*=
@@ -120,8 +123,8 @@ namespace AMDiS {
     {
       typedef T result_type;
       
-      static T& apply(T& v, T const& v0) { return (v *= v0); }
-      T& operator()(T& v, T const& v0) { return (v *= v0); }
+      static constexpr T& apply(T& v, T const& v0) { return (v *= v0); }
+      constexpr T& operator()(T& v, T const& v0) { return (v *= v0); }
     };
 
     /// functor for operator/=
@@ -130,8 +133,8 @@ namespace AMDiS {
     {
       typedef T result_type;
       
-      static T& apply(T& v, T const& v0) { return (v /= v0); }
-      T& operator()(T& v, T const& v0) { return (v /= v0); }
+      static constexpr T& apply(T& v, T const& v0) { return (v /= v0); }
+      constexpr T& operator()(T& v, T const& v0) { return (v /= v0); }
     };
 
     /// functor for v = max(v, v0)
@@ -140,8 +143,8 @@ namespace AMDiS {
     {
       typedef T result_type;
       
-      static T& apply(T& v, T const& v0) { return v = std::max(v, v0); }
-      T& operator()(T& v, T const& v0) { return v = std::max(v, v0); }
+      static constexpr T& apply(T& v, T const& v0) { return v = std::max(v, v0); }
+      constexpr T& operator()(T& v, T const& v0) { return v = std::max(v, v0); }
     };
 
     /// functor for v = min(v, v0)
@@ -150,8 +153,28 @@ namespace AMDiS {
     {
       typedef T result_type;
       
-      static T& apply(T& v, T const& v0) { return v = std::min(v, v0); }
-      T& operator()(T& v, T const& v0) { return v = std::min(v, v0); }
+      static constexpr T& apply(T& v, T const& v0) { return v = std::min(v, v0); }
+      constexpr T& operator()(T& v, T const& v0) { return v = std::min(v, v0); }
+    };
+
+    /// functor for v = v || v0
+    template <class T>
+    struct logical_or
+    {
+      typedef T result_type;
+      
+      static constexpr T& apply(T& v, T const& v0) { return v = (v || v0); }
+      constexpr T& operator()(T& v, T const& v0) const { return v = (v || v0); }
+    };
+
+    /// functor for v = v && v0
+    template <class T>
+    struct logical_and
+    {
+      typedef T result_type;
+      
+      static constexpr T& apply(T& v, T const& v0) { return v = (v && v0); }
+      constexpr T& operator()(T& v, T const& v0) const { return v = (v && v0); }
     };
 
   } // end namespace assign
@@ -0,0 +1,231 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file compensated.hpp */
+
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+#include "traits/concepts.hpp"
+#include "traits/mult_type.hpp"
+#include "operations/generic_loops.hpp"	// meta::BLOCKED, meta::UNROLL
+#include "operations/packet.hpp"		// simd::Packet
+
+namespace AMDiS 
+{
+  namespace functors
+  {
+    /// partial result of a compensated summation: the rounded sum and the 
+    /// accumulated rounding errors of the additions.
+    template <class T>
+    struct compensated_value
+    {
+      T sum;
+      T error;
+    };
+    
+    /// \cond HIDDEN_SYMBOLS
+    namespace aux
+    {
+      // value.sum += x, the rounding error is added to value.error. Knuth's 
+      // branch free TwoSum, i.e. it can be evaluated on packets.
+      template <class T>
+      inline void two_sum(compensated_value<T>& value, T const& x)
+      {
+	T const t = value.sum + x;
+	T const z = t - value.sum;
+	value.error += (value.sum - (t - z)) + (x - z);
+	value.sum = t;
+      }
+      
+    } // end namespace aux
+    /// \endcond
+    
+    
+    /// Reduction functor for a compensated sum (Kahan-Babuska-Neumaier)
+    /** The rounding error of each addition is computed exactly and 
+     *  accumulated separately, so that the error of the sum is about
+     *  eps*|sum| + n*eps^2*sum|v_i|, instead of n*eps*sum|v_i|.
+     *  The accumulators are \ref compensated_value s:
+     *  init: result = (0, 0), 
+     *  update: result += v_i, 
+     *  finish: compensated addition of the sums, errors are added,
+     *  post_reduction: result = sum + error
+     *  
+     *  The error-free transformation requires IEEE arithmetic, i.e. it does 
+     *  not work with -ffast-math. For real values only.
+     **/
+    template <class T>
+    struct compensated_sum_functor
+    {
+      typedef T                     result_type;
+      typedef compensated_value<T>  accumulator_type;
+      
+      template <typename Value>
+      static inline void init(compensated_value<Value>& value)
+      {
+	value.sum = Value{};
+	value.error = Value{};
+      }
+
+      template <typename Value, typename Element>
+      static inline void update(compensated_value<Value>& value, const Element& x)
+      {    
+	aux::two_sum(value, Value(x));
+      }
+
+      template <typename Value>
+      static inline void finish(compensated_value<Value>& value, const compensated_value<Value>& value2)
+      {
+	aux::two_sum(value, value2.sum);
+	value.error += value2.error;
+      }
+
+      template <typename Value>
+      static inline Value post_reduction(const compensated_value<Value>& value)
+      {
+	return value.sum + value.error;
+      }
+    };
+    
+    
+    /// Binary reduction functor for a compensated scalar product
+    /** Same as \ref compensated_sum_functor, with the summands v_i * w_i. 
+     *  The products are rounded once, only the summation is compensated.
+     **/
+    template <class A, class B>
+    struct compensated_dot_functor
+      : compensated_sum_functor<traits::mult_type<A, B>>
+    {
+      template <typename Value, typename Element1, typename Element2>
+      static inline void update(compensated_value<Value>& value, const Element1& x, const Element2& y)
+      {    
+	aux::two_sum(value, Value(x * y));
+      }
+    };
+    
+    
+    /// Reduction functor for a compensated ||v||_2
+    /** Same as \ref compensated_sum_functor, with the summands v_i^2 and the 
+     *  square root in post_reduction.
+     **/
+    template <class T>
+    struct compensated_two_norm_functor
+      : compensated_sum_functor<T>
+    {
+      template <typename Value, typename Element>
+      static inline void update(compensated_value<Value>& value, const Element& x)
+      {    
+	aux::two_sum(value, Value(x * x));
+      }
+      
+      template <typename Value>
+      static inline Value post_reduction(const compensated_value<Value>& value)
+      {
+	using std::sqrt;
+	return sqrt(value.sum + value.error);
+      }
+    };
+    
+  } // end namespace functors
+  
+  
+  /// concept for a reduction functor \p F with compensated accumulators of type \p T
+  template <class F, class T>
+  concept bool Compensated_sfunctor = 
+    std::is_same<Accumulator_type<F>, functors::compensated_value<T>>::value;
+  
+  
+  namespace simd
+  {
+    /// \brief compensated reduction of a runtime number of elements by packets.
+    /** Like \ref BLOCKED, but the accumulators are \p P packets of sums with 
+     *  a packet of rounding errors each, i.e. every lane has its own 
+     *  compensation term. The packets and afterwards the lanes are combined 
+     *  pairwise with the compensated Functor::finish.
+     **/
+    template <long P>
+    struct COMPENSATED
+    {
+      /// result = reduce_i{ f(a_i) }, i in [0, n)
+      template <class A, class T, class Functor>
+      static void accumulate(A const& a, size_t n, functors::compensated_value<T>& result, Functor f)
+      {
+	constexpr long W = packet_traits<T>::size;
+	using meta::UNROLL;
+	
+	functors::compensated_value<Packet<T>> acc[P];
+	UNROLL<0,P>::apply([&](auto p) { Functor::init(acc[p]); });
+	
+	size_t i = 0;
+	for (; i + P*W <= n; i += P*W)
+	  UNROLL<0,P>::apply([&](auto p) { Functor::update(acc[p], a.packet(i + p*W)); });
+	
+	combine(acc, result, f);
+	for (; i < n; ++i)
+	  Functor::update(result, a(i));
+      }
+      
+      /// result = reduce_i{ f(a_i, b_i) }, i in [0, n)
+      template <class A, class B, class T, class Functor>
+      static void inner_product(A const& a, B const& b, size_t n, functors::compensated_value<T>& result, Functor f)
+      {
+	constexpr long W = packet_traits<T>::size;
+	using meta::UNROLL;
+	
+	functors::compensated_value<Packet<T>> acc[P];
+	UNROLL<0,P>::apply([&](auto p) { Functor::init(acc[p]); });
+	
+	size_t i = 0;
+	for (; i + P*W <= n; i += P*W)
+	  UNROLL<0,P>::apply([&](auto p) { 
+	    Functor::update(acc[p], a.packet(i + p*W), b.packet(i + p*W)); 
+	  });
+	
+	combine(acc, result, f);
+	for (; i < n; ++i)
+	  Functor::update(result, a(i), b(i));
+      }
+      
+    private:
+      // compensated horizontal reduction of the packets and of the lanes
+      template <class T, class Functor>
+      static void combine(functors::compensated_value<Packet<T>> (&acc)[P], 
+			  functors::compensated_value<T>& result, Functor f)
+      {
+	constexpr long W = packet_traits<T>::size;
+	meta::BLOCKED<P>::combine(acc, f);
+	
+	functors::compensated_value<T> lanes[W];
+	meta::UNROLL<0,W>::apply([&](auto k) { 
+	  lanes[k].sum = acc[0].sum[int(k)];
+	  lanes[k].error = acc[0].error[int(k)];
+	});
+	meta::BLOCKED<W>::combine(lanes, f);
+	result = lanes[0];
+      }
+    };
+    
+  } // end namespace simd
+} // end namespace AMDiS
@@ -0,0 +1,241 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file cpu_dispatch.hpp */
+
+#pragma once
+
+#include "Config.h"			// HAS_CPU_DISPATCH, TARGET, FLATTEN, NO_FP_CONTRACT, SIMD_BYTES, REPRODUCIBLE_SIMD
+#include "operations/meta.hpp"
+#include "operations/generic_loops.hpp"	// meta::BLOCKED
+#include "operations/packet.hpp"		// simd::BLOCKED, simd::assign
+
+namespace AMDiS 
+{
+  namespace simd
+  {
+    /// instruction sets of x86 processors, that are distinguished by the 
+    /// runtime dispatch of the dynamic-size kernels.
+    enum class Isa { sse2, avx2, avx512 };
+    
+    /// detect the best instruction set supported by the cpu, using cpuid.
+    /// The AVX-512 kernels are compiled for avx512f, avx512vl and avx512dq.
+    inline Isa detect_isa()
+    {
+#if HAS_CPU_DISPATCH
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") && 
+	  __builtin_cpu_supports("avx512dq"))
+	return Isa::avx512;
+      if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	return Isa::avx2;
+#endif
+      return Isa::sse2;
+    }
+    
+    /// instruction set of the cpu, detected once at the first call
+    inline Isa cpu_isa()
+    {
+      static const Isa isa = detect_isa();
+      return isa;
+    }
+    
+    /// width of the SIMD packets in bytes of the kernels for the instruction 
+    /// set \p I: the native register width, or SIMD_BYTES for all instruction
+    /// sets if REPRODUCIBLE_SIMD is set.
+    template <Isa I>
+    struct isa_bytes : int_<(REPRODUCIBLE_SIMD || I == Isa::sse2 ? SIMD_BYTES : I == Isa::avx2 ? 32 : 64)> {};
+    
+    /// \cond HIDDEN_SYMBOLS
+    namespace aux
+    {
+      /// \brief dynamic-size kernels with packets of \p Bytes width, compiled 
+      /// for each instruction set.
+      /** Expressions with packet access are evaluated by SIMD packets, all 
+       *  others elementwise. The number of accumulators, and thus the order 
+       *  of the operations in reductions, depends on the packet width. 
+       *  Elementwise results are the same for all widths.
+       **/
+      template <int Bytes>
+      struct kernels
+      {
+	// 4 SIMD registers of independent accumulators
+	template <class T>
+	static constexpr long accumulators() { return 4 * max(Bytes / long(sizeof(T)), 1L); }
+	
+	template <class T, class Source, class Assigner>
+	static void assign(T* a, Source const& src, size_t n, Assigner)
+	{
+	  for (size_t i = 0; i < n; ++i)
+	    Assigner::apply(a[i], src(i));
+	}
+	
+	// SIMD packets and a scalar tail
+	template <class T, class Source, class Assigner>
+	  requires Packet_access<Source, T>
+	static void assign(T* a, Source const& src, size_t n, Assigner assigner)
+	{
+	  size_t i = simd::assign<Bytes>(a, src, n, assigner);
+	  for (; i < n; ++i)
+	    Assigner::apply(a[i], src(i));
+	}
+	
+	template <class A, class T, class Functor>
+	static void accumulate(A const& a, size_t n, T& result, Functor f)
+	{
+	  meta::BLOCKED<accumulators<T>()>::accumulate(a, n, result, f);
+	}
+	
+	// 4 SIMD packets of independent accumulators
+	template <class A, class T, class Functor>
+	  requires Packet_access<A, T> && Packet_reduction<Functor, T>
+	static void accumulate(A const& a, size_t n, T& result, Functor f)
+	{
+	  simd::BLOCKED<4, Bytes>::accumulate(a, n, result, f);
+	}
+	
+	template <class A, class B, class T, class Functor>
+	static void inner_product(A const& a, B const& b, size_t n, T& result, Functor f)
+	{
+	  meta::BLOCKED<accumulators<T>()>::inner_product(a, b, n, result, f);
+	}
+	
+	// 4 SIMD packets of independent accumulators
+	template <class A, class B, class T, class Functor>
+	  requires Packet_access<A, T> && Packet_access<B, T> && Packet_reduction<Functor, T>
+	static void inner_product(A const& a, B const& b, size_t n, T& result, Functor f)
+	{
+	  simd::BLOCKED<4, Bytes>::inner_product(a, b, n, result, f);
+	}
+      };
+      
+#if HAS_CPU_DISPATCH
+      // The kernels are compiled for the target instruction set. FLATTEN
+      // inlines all calls, i.e. also the evaluation of the expressions. 
+      // NO_FP_CONTRACT prevents the contraction of a*b+c to fma, that is 
+      // available on AVX2 and AVX-512 only, i.e. all versions round the 
+      // elements alike.
+#define AVX512_TARGET TARGET("avx512f,avx512dq,avx512vl,prefer-vector-width=512") FLATTEN NO_FP_CONTRACT
+#define AVX2_TARGET   TARGET("avx2,fma") FLATTEN NO_FP_CONTRACT
+      
+      template <class T, class Source, class Assigner>
+      AVX512_TARGET void assign_avx512(T* a, Source const& src, size_t n, Assigner assigner)
+      {
+	kernels<isa_bytes<Isa::avx512>::value>::assign(a, src, n, assigner);
+      }
+      
+      template <class T, class Source, class Assigner>
+      AVX2_TARGET void assign_avx2(T* a, Source const& src, size_t n, Assigner assigner)
+      {
+	kernels<isa_bytes<Isa::avx2>::value>::assign(a, src, n, assigner);
+      }
+      
+      template <class A, class T, class Functor>
+      AVX512_TARGET void accumulate_avx512(A const& a, size_t n, T& result, Functor f)
+      {
+	kernels<isa_bytes<Isa::avx512>::value>::accumulate(a, n, result, f);
+      }
+      
+      template <class A, class T, class Functor>
+      AVX2_TARGET void accumulate_avx2(A const& a, size_t n, T& result, Functor f)
+      {
+	kernels<isa_bytes<Isa::avx2>::value>::accumulate(a, n, result, f);
+      }
+      
+      template <class A, class B, class T, class Functor>
+      AVX512_TARGET void inner_product_avx512(A const& a, B const& b, size_t n, T& result, Functor f)
+      {
+	kernels<isa_bytes<Isa::avx512>::value>::inner_product(a, b, n, result, f);
+      }
+      
+      template <class A, class B, class T, class Functor>
+      AVX2_TARGET void inner_product_avx2(A const& a, B const& b, size_t n, T& result, Functor f)
+      {
+	kernels<isa_bytes<Isa::avx2>::value>::inner_product(a, b, n, result, f);
+      }
+      
+#undef AVX512_TARGET
+#undef AVX2_TARGET
+#endif
+      
+    } // end namespace aux
+    /// \endcond
+    
+    
+    /// \brief dynamic-size kernels with runtime dispatch to the instruction 
+    /// set of the cpu.
+    /** If HAS_CPU_DISPATCH is set, i.e. for x86 builds that do not target 
+     *  AVX-512 anyway, each kernel is compiled for SSE2 (the baseline), 
+     *  AVX2 and AVX-512, and the best version is chosen by \ref cpu_isa(). 
+     *  Otherwise the kernels use the baseline instruction set only. The 
+     *  SIMD packets have the native width of the instruction set, see 
+     *  \ref isa_bytes, so the results of reductions may differ between 
+     *  cpus in the last bits. Define REPRODUCIBLE_SIMD to 1 for packets of 
+     *  SIMD_BYTES in all versions, i.e. the same results on all cpus.
+     **/
+    namespace cpu
+    {
+      /// a[i] = src(i) (or compound assignment given by the Assigner), i in [0, n)
+      template <class T, class Source, class Assigner>
+      inline void assign(T* a, Source const& src, size_t n, Assigner assigner)
+      {
+#if HAS_CPU_DISPATCH
+	switch (cpu_isa()) {
+	  case Isa::avx512: aux::assign_avx512(a, src, n, assigner); return;
+	  case Isa::avx2:   aux::assign_avx2(a, src, n, assigner); return;
+	  default: break;
+	}
+#endif
+	aux::kernels<isa_bytes<Isa::sse2>::value>::assign(a, src, n, assigner);
+      }
+      
+      /// result = reduce_i{ f(a_i) }, i in [0, n)
+      template <class A, class T, class Functor>
+      inline void accumulate(A const& a, size_t n, T& result, Functor f)
+      {
+#if HAS_CPU_DISPATCH
+	switch (cpu_isa()) {
+	  case Isa::avx512: aux::accumulate_avx512(a, n, result, f); return;
+	  case Isa::avx2:   aux::accumulate_avx2(a, n, result, f); return;
+	  default: break;
+	}
+#endif
+	aux::kernels<isa_bytes<Isa::sse2>::value>::accumulate(a, n, result, f);
+      }
+      
+      /// result = reduce_i{ f(a_i, b_i) }, i in [0, n)
+      template <class A, class B, class T, class Functor>
+      inline void inner_product(A const& a, B const& b, size_t n, T& result, Functor f)
+      {
+#if HAS_CPU_DISPATCH
+	switch (cpu_isa()) {
+	  case Isa::avx512: aux::inner_product_avx512(a, b, n, result, f); return;
+	  case Isa::avx2:   aux::inner_product_avx2(a, b, n, result, f); return;
+	  default: break;
+	}
+#endif
+	aux::kernels<isa_bytes<Isa::sse2>::value>::inner_product(a, b, n, result, f);
+      }
+      
+    } // end namespace cpu
+  } // end namespace simd
+} // end namespace AMDiS
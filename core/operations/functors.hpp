@@ -26,6 +26,7 @@
 
 #include <complex>
 #include <cmath>
+#include <utility>	// std::declval
 
 #include <boost/math/special_functions/cbrt.hpp>
 #include <boost/math/special_functions/pow.hpp> 
@@ -54,9 +55,9 @@ namespace AMDiS
       typedef T result_type;
       int degree(int d0) const { return d0; }
 
-      static T eval(const T& v) { return v; }
-      static T apply(const T& v) { return v; }
-      T operator()(const T& v) const { return eval(v); }
+      static constexpr T eval(const T& v) { return v; }
+      static constexpr T apply(const T& v) { return v; }
+      constexpr T operator()(const T& v) const { return eval(v); }
     };
 
     // -------------------------------------------------------------------------
@@ -90,6 +91,120 @@ namespace AMDiS
     };
     
 
+    // -------------------------------------------------------------------------
+    // arithmetic operators, usable in constant expressions
+    
+    /// a + b
+    template <class T1, class T2>
+    struct plus : FunctorBase
+    {
+      typedef decltype( std::declval<T1>() + std::declval<T2>() ) result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a + b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// a - b
+    template <class T1, class T2>
+    struct minus : FunctorBase
+    {
+      typedef decltype( std::declval<T1>() - std::declval<T2>() ) result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a - b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// a * b
+    template <class T1, class T2>
+    struct times : FunctorBase
+    {
+      typedef decltype( std::declval<T1>() * std::declval<T2>() ) result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a * b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// a / b
+    template <class T1, class T2>
+    struct divide : FunctorBase
+    {
+      typedef decltype( std::declval<T1>() / std::declval<T2>() ) result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a / b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// -a
+    template <class T>
+    struct negate : FunctorBase
+    {
+      typedef decltype( -std::declval<T>() ) result_type;
+      typedef result_type                     value_type;
+      
+      static constexpr result_type apply(const T& a) { return -a; }
+      constexpr result_type operator()(const T& a) const { return apply(a); }
+    };
+    
+    /// a < b
+    template <class T1, class T2>
+    struct less : FunctorBase
+    {
+      typedef bool result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a < b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// a <= b
+    template <class T1, class T2>
+    struct less_equal : FunctorBase
+    {
+      typedef bool result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a <= b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// a > b
+    template <class T1, class T2>
+    struct greater : FunctorBase
+    {
+      typedef bool result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a > b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// a >= b
+    template <class T1, class T2>
+    struct greater_equal : FunctorBase
+    {
+      typedef bool result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a >= b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// a == b
+    template <class T1, class T2>
+    struct equal_to : FunctorBase
+    {
+      typedef bool result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a == b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+    
+    /// a != b
+    template <class T1, class T2>
+    struct not_equal_to : FunctorBase
+    {
+      typedef bool result_type;
+      
+      static constexpr result_type apply(const T1& a, const T2& b) { return a != b; }
+      constexpr result_type operator()(const T1& a, const T2& b) const { return apply(a, b); }
+    };
+
     // -------------------------------------------------------------------------
     /// abs(v) == |v|
     template <class T>
@@ -98,9 +213,9 @@ namespace AMDiS
       typedef T result_type;
       int getDegree(int d0) const { return d0; }
 
-      static result_type eval(const T& v) { return std::abs(v); }
-      static result_type apply(const T& v) { return std::abs(v); }
-      result_type operator()(const T &v) const { return eval(v); }
+      static constexpr result_type eval(const T& v) { return std::abs(v); }
+      static constexpr result_type apply(const T& v) { return std::abs(v); }
+      constexpr result_type operator()(const T &v) const { return eval(v); }
     };
 
     /// \cond HIDDEN_SYMBOLS
@@ -259,6 +374,7 @@ namespace AMDiS
     struct root : FunctorBase
     {
       typedef T result_type;
+      typedef T  value_type;
       int getDegree(int d0) const { return p*d0; } // optimal polynomial approximation degree ?
 
       static result_type eval(const T& v) { return root_dispatch<p,T>::eval(v); }
@@ -317,7 +433,7 @@ namespace AMDiS
       G g;
       
       template <class T>
-      result_type& operator()(T& v, T const& v0) { return f(g(v), v0); }
+      constexpr result_type& operator()(T& v, T const& v0) { return f(g(v), v0); }
     };
     
     template <class F, class G>
@@ -328,7 +444,7 @@ namespace AMDiS
       G g;
       
       template <class T>
-      result_type& operator()(T& v, T const& v0) { return f(v, g(v0)); }
+      constexpr result_type& operator()(T& v, T const& v0) { return f(v, g(v0)); }
     };
 
   } // end namespace functors
@@ -133,7 +133,7 @@ namespace AMDiS {
       }
       
       template <class A, class B, class T, class Functor>
-      static void inner_product(A const&, B const&, T&, Functor) { }
+      static constexpr void inner_product(A const&, B const&, T&, Functor) { }
     };
     /// \endcond
     
@@ -266,7 +266,7 @@ namespace AMDiS {
       
       // inner product, using one functor that includes both binary operators
       template<class A, class B, class T, class Functor>
-      static void inner_product(A const& a, B const& b, T& init, Functor f)
+      static constexpr void inner_product(A const& a, B const& b, T& init, Functor f)
       {
 	Functor::update(init, a(I), b(I));
 	FOR<I+1,N>::inner_product(a, b, init, f);
@@ -308,5 +308,170 @@ namespace AMDiS {
 //     };
     /// \endcond
     
+    
+    /// generic loop that calls a functor with the compile-time index int_<I>
+    /** Used to write fully unrolled kernels, e.g. with generic lambdas:
+     *  UNROLL<0,N>::apply([&](auto i) { c[i] = a(i, k) * b(k); });
+     **/
+    template <long I, long N>
+    struct UNROLL
+    {
+      template <class F>
+      static void apply(F f)
+      {
+	f(int_<I>());  UNROLL<I+1,N>::apply(f);
+      }
+    };
+    
+    /// \cond HIDDEN_SYMBOLS
+    template <long N>
+    struct UNROLL<N, N>
+    {
+      template <class F>
+      static void apply(F) {}
+    };
+    /// \endcond
+    
+    
+    /// maps a runtime size \p s in [I, N] to the compile-time constant int_<s>
+    /** Calls f(int_<s>()), so that f can use fully unrolled loops, e.g. 
+     *  SWITCH<1,N>::apply(size, [&](auto s) { FOR<0,decltype(s)::value>::... });
+     *  Sizes outside of [I, N] are ignored.
+     **/
+    template <long I, long N>
+    struct SWITCH
+    {
+      template <class F>
+      static void apply(size_t s, F f)
+      {
+	if (s == I)
+	  f(int_<I>());
+	else
+	  SWITCH<I+1,N>::apply(s, f);
+      }
+    };
+    
+    /// \cond HIDDEN_SYMBOLS
+    template <long N>
+    struct SWITCH<N, N>
+    {
+      template <class F>
+      static void apply(size_t s, F f)
+      {
+	if (s == N)
+	  f(int_<N>());
+      }
+    };
+    /// \endcond
+    
+    
+    /// unrolled reduction of the \p N elements [I, I+N) with a balanced tree
+    /** The range is split into two halves, that are reduced independently 
+     *  and combined with Functor::finish. In contrast to the linear 
+     *  accumulation in \ref FOR the dependency chain has length log2(N),
+     *  so that the partial results can be computed in parallel (pipelined
+     *  or vectorized).
+     **/
+    template <long I, long N>
+    struct TREE
+    {
+      static constexpr long H = N / 2;
+      
+      /// result = reduce_i{ f(a_i) }
+      template <class A, class T, class Functor>
+      static constexpr void accumulate(A const& a, T& result, Functor f)
+      {
+	T right{};
+	TREE<I, H>::accumulate(a, result, f);
+	TREE<I+H, N-H>::accumulate(a, right, f);
+	Functor::finish(result, right);
+      }
+      
+      /// result = reduce_i{ f(a_i, b_i) }
+      template <class A, class B, class T, class Functor>
+      static constexpr void inner_product(A const& a, B const& b, T& result, Functor f)
+      {
+	T right{};
+	TREE<I, H>::inner_product(a, b, result, f);
+	TREE<I+H, N-H>::inner_product(a, b, right, f);
+	Functor::finish(result, right);
+      }
+    };
+    
+    /// \cond HIDDEN_SYMBOLS
+    template <long I>
+    struct TREE<I, 1>
+    {
+      template <class A, class T, class Functor>
+      static constexpr void accumulate(A const& a, T& result, Functor)
+      {
+	Functor::init(result);
+	Functor::update(result, a(I));
+      }
+      
+      template <class A, class B, class T, class Functor>
+      static constexpr void inner_product(A const& a, B const& b, T& result, Functor)
+      {
+	Functor::init(result);
+	Functor::update(result, a(I), b(I));
+      }
+    };
+    /// \endcond
+    
+    
+    /// reduction of a runtime number of elements with \p K independent accumulators
+    /** Element i is accumulated into acc[i % K], the accumulators are combined 
+     *  by a pairwise (horizontal) reduction with Functor::finish at the end. 
+     *  The independent accumulators break the dependency chain of the update
+     *  operation, and consecutive accumulators form SIMD packets, so that the
+     *  main loop can be vectorized.
+     **/
+    template <long K>
+    struct BLOCKED
+    {
+      /// result = reduce_i{ f(a_i) }, i in [0, n)
+      template <class A, class T, class Functor>
+      static void accumulate(A const& a, size_t n, T& result, Functor f)
+      {
+	T acc[K];
+	UNROLL<0,K>::apply([&](auto k) { Functor::init(acc[k]); });
+	
+	size_t i = 0;
+	for (; i + K <= n; i += K)
+	  UNROLL<0,K>::apply([&](auto k) { Functor::update(acc[k], a(i + k)); });
+	for (; i < n; ++i)
+	  Functor::update(acc[0], a(i));
+	
+	combine(acc, f);
+	result = acc[0];
+      }
+      
+      /// result = reduce_i{ f(a_i, b_i) }, i in [0, n)
+      template <class A, class B, class T, class Functor>
+      static void inner_product(A const& a, B const& b, size_t n, T& result, Functor f)
+      {
+	T acc[K];
+	UNROLL<0,K>::apply([&](auto k) { Functor::init(acc[k]); });
+	
+	size_t i = 0;
+	for (; i + K <= n; i += K)
+	  UNROLL<0,K>::apply([&](auto k) { Functor::update(acc[k], a(i + k), b(i + k)); });
+	for (; i < n; ++i)
+	  Functor::update(acc[0], a(i), b(i));
+	
+	combine(acc, f);
+	result = acc[0];
+      }
+      
+      /// horizontal reduction acc[0] = finish(acc[0], ..., acc[K-1])
+      template <class T, class Functor>
+      static void combine(T (&acc)[K], Functor)
+      {
+	for (long s = 1; s < K; s *= 2)
+	  for (long k = 0; k + s < K; k += 2*s)
+	    Functor::finish(acc[k], acc[k + s]);
+      }
+    };
+    
   } // end namespace meta
 } // end namespace AMDiS
@@ -0,0 +1,348 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file inverse.hpp */
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "Log.h"			// TEST_EXIT
+#include "traits/concepts.hpp"
+#include "traits/compute_type.hpp"
+#include "traits/num_rows.hpp"
+#include "traits/num_cols.hpp"
+#include "traits/eval_cost.hpp"		// traits::functor_flops
+#include "operations/functors.hpp"	// FunctorBase
+#include "operations/generic_loops.hpp"	// meta::UNROLL, meta::SWITCH
+
+namespace AMDiS 
+{
+  /// \brief modes of the test for singular matrices in \ref inv
+  namespace singular
+  {
+    /// no test, a singular matrix gives inf or nan entries
+    struct ignore {};
+    
+    /// error, if |det(A)| <= N*eps * |A_0|_1 * ... * |A_N-1|_1, with the 
+    /// rows A_i of the N x N matrix A
+    struct check {};
+    
+  } // end namespace singular
+  
+  /// concept for the modes in namespace \ref singular
+  template <class Mode>
+  concept bool Singular_mode = 
+    std::is_same<Mode, singular::ignore>::value || std::is_same<Mode, singular::check>::value;
+  
+  
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    // largest size of a matrix of type E, that is handled by the closed-form 
+    // formulas: the static number of rows, or 4 for dynamic sizes
+    template <class E>
+    constexpr int max_inverse_size() { return E::_ROWS > 0 ? E::_ROWS : 4; }
+    
+    // flops of the cofactor formulas for det and inv of size n
+    constexpr int determinant_flops(int n) { return n == 2 ? 3 : n == 3 ? 14 : n == 4 ? 47 : 0; }
+    constexpr int inverse_flops(int n) { return n == 2 ? 8 : n == 3 ? 42 : n == 4 ? 144 : 1; }
+    
+    // a = A, the entries as local variables
+    template <class E, class T, int N>
+    inline void load(E const& A, T (&a)[N][N])
+    {
+      meta::UNROLL<0,N>::apply([&](auto i) {
+	meta::UNROLL<0,N>::apply([&](auto j) { a[i][j] = A(i, j); });
+      });
+    }
+    
+    // B = b
+    template <class M, class T, int N>
+    inline void store(T const (&b)[N][N], M& B)
+    {
+      meta::UNROLL<0,N>::apply([&](auto i) {
+	meta::UNROLL<0,N>::apply([&](auto j) { B(i, j) = b[i][j]; });
+      });
+    }
+    
+    // ----- cofactor formulas for det(a) --------------------------------------
+    
+    template <class T>
+    inline T determinant(T const (&a)[1][1])
+    {
+      return a[0][0];
+    }
+    
+    template <class T>
+    inline T determinant(T const (&a)[2][2])
+    {
+      return a[0][0]*a[1][1] - a[0][1]*a[1][0];
+    }
+    
+    template <class T>
+    inline T determinant(T const (&a)[3][3])
+    {
+      return a[0][0]*(a[1][1]*a[2][2] - a[1][2]*a[2][1])
+	   - a[0][1]*(a[1][0]*a[2][2] - a[1][2]*a[2][0])
+	   + a[0][2]*(a[1][0]*a[2][1] - a[1][1]*a[2][0]);
+    }
+    
+    // Laplace expansion by the 2x2 minors s of the rows 0,1 and c of the rows 2,3
+    template <class T>
+    inline T determinant(T const (&a)[4][4])
+    {
+      T const s0 = a[0][0]*a[1][1] - a[1][0]*a[0][1];
+      T const s1 = a[0][0]*a[1][2] - a[1][0]*a[0][2];
+      T const s2 = a[0][0]*a[1][3] - a[1][0]*a[0][3];
+      T const s3 = a[0][1]*a[1][2] - a[1][1]*a[0][2];
+      T const s4 = a[0][1]*a[1][3] - a[1][1]*a[0][3];
+      T const s5 = a[0][2]*a[1][3] - a[1][2]*a[0][3];
+      
+      T const c0 = a[2][0]*a[3][1] - a[3][0]*a[2][1];
+      T const c1 = a[2][0]*a[3][2] - a[3][0]*a[2][2];
+      T const c2 = a[2][0]*a[3][3] - a[3][0]*a[2][3];
+      T const c3 = a[2][1]*a[3][2] - a[3][1]*a[2][2];
+      T const c4 = a[2][1]*a[3][3] - a[3][1]*a[2][3];
+      T const c5 = a[2][2]*a[3][3] - a[3][2]*a[2][3];
+      
+      return s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+    }
+    
+    // ----- b = a^(-1) = adj(a) / det(a), returns det(a) ----------------------
+    
+    template <class T>
+    inline T inverse(T const (&a)[1][1], T (&b)[1][1])
+    {
+      b[0][0] = T(1) / a[0][0];
+      return a[0][0];
+    }
+    
+    template <class T>
+    inline T inverse(T const (&a)[2][2], T (&b)[2][2])
+    {
+      T const d = determinant(a);
+      T const r = T(1) / d;
+      b[0][0] =  a[1][1]*r;  b[0][1] = -a[0][1]*r;
+      b[1][0] = -a[1][0]*r;  b[1][1] =  a[0][0]*r;
+      return d;
+    }
+    
+    template <class T>
+    inline T inverse(T const (&a)[3][3], T (&b)[3][3])
+    {
+      // first column of the adjugate
+      T const b00 = a[1][1]*a[2][2] - a[1][2]*a[2][1];
+      T const b10 = a[1][2]*a[2][0] - a[1][0]*a[2][2];
+      T const b20 = a[1][0]*a[2][1] - a[1][1]*a[2][0];
+      
+      T const d = a[0][0]*b00 + a[0][1]*b10 + a[0][2]*b20;
+      T const r = T(1) / d;
+      
+      b[0][0] = b00*r;
+      b[0][1] = (a[0][2]*a[2][1] - a[0][1]*a[2][2])*r;
+      b[0][2] = (a[0][1]*a[1][2] - a[0][2]*a[1][1])*r;
+      b[1][0] = b10*r;
+      b[1][1] = (a[0][0]*a[2][2] - a[0][2]*a[2][0])*r;
+      b[1][2] = (a[0][2]*a[1][0] - a[0][0]*a[1][2])*r;
+      b[2][0] = b20*r;
+      b[2][1] = (a[0][1]*a[2][0] - a[0][0]*a[2][1])*r;
+      b[2][2] = (a[0][0]*a[1][1] - a[0][1]*a[1][0])*r;
+      return d;
+    }
+    
+    // cofactors by the 2x2 minors s of the rows 0,1 and c of the rows 2,3
+    template <class T>
+    inline T inverse(T const (&a)[4][4], T (&b)[4][4])
+    {
+      T const s0 = a[0][0]*a[1][1] - a[1][0]*a[0][1];
+      T const s1 = a[0][0]*a[1][2] - a[1][0]*a[0][2];
+      T const s2 = a[0][0]*a[1][3] - a[1][0]*a[0][3];
+      T const s3 = a[0][1]*a[1][2] - a[1][1]*a[0][2];
+      T const s4 = a[0][1]*a[1][3] - a[1][1]*a[0][3];
+      T const s5 = a[0][2]*a[1][3] - a[1][2]*a[0][3];
+      
+      T const c0 = a[2][0]*a[3][1] - a[3][0]*a[2][1];
+      T const c1 = a[2][0]*a[3][2] - a[3][0]*a[2][2];
+      T const c2 = a[2][0]*a[3][3] - a[3][0]*a[2][3];
+      T const c3 = a[2][1]*a[3][2] - a[3][1]*a[2][2];
+      T const c4 = a[2][1]*a[3][3] - a[3][1]*a[2][3];
+      T const c5 = a[2][2]*a[3][3] - a[3][2]*a[2][3];
+      
+      T const d = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+      T const r = T(1) / d;
+      
+      b[0][0] = ( a[1][1]*c5 - a[1][2]*c4 + a[1][3]*c3)*r;
+      b[0][1] = (-a[0][1]*c5 + a[0][2]*c4 - a[0][3]*c3)*r;
+      b[0][2] = ( a[3][1]*s5 - a[3][2]*s4 + a[3][3]*s3)*r;
+      b[0][3] = (-a[2][1]*s5 + a[2][2]*s4 - a[2][3]*s3)*r;
+      
+      b[1][0] = (-a[1][0]*c5 + a[1][2]*c2 - a[1][3]*c1)*r;
+      b[1][1] = ( a[0][0]*c5 - a[0][2]*c2 + a[0][3]*c1)*r;
+      b[1][2] = (-a[3][0]*s5 + a[3][2]*s2 - a[3][3]*s1)*r;
+      b[1][3] = ( a[2][0]*s5 - a[2][2]*s2 + a[2][3]*s1)*r;
+      
+      b[2][0] = ( a[1][0]*c4 - a[1][1]*c2 + a[1][3]*c0)*r;
+      b[2][1] = (-a[0][0]*c4 + a[0][1]*c2 - a[0][3]*c0)*r;
+      b[2][2] = ( a[3][0]*s4 - a[3][1]*s2 + a[3][3]*s0)*r;
+      b[2][3] = (-a[2][0]*s4 + a[2][1]*s2 - a[2][3]*s0)*r;
+      
+      b[3][0] = (-a[1][0]*c3 + a[1][1]*c1 - a[1][2]*c0)*r;
+      b[3][1] = ( a[0][0]*c3 - a[0][1]*c1 + a[0][2]*c0)*r;
+      b[3][2] = (-a[3][0]*s3 + a[3][1]*s1 - a[3][2]*s0)*r;
+      b[3][3] = ( a[2][0]*s3 - a[2][1]*s1 + a[2][2]*s0)*r;
+      return d;
+    }
+    
+    // ----- singularity test --------------------------------------------------
+    
+    template <class T, int N>
+    inline void test_singular(T const (&)[N][N], T const&, singular::ignore) {}
+    
+    template <class T, int N>
+    inline void test_singular(T const (&a)[N][N], T const& d, singular::check)
+    {
+      using std::abs;
+      typedef decltype(abs(d)) real_type;
+      
+      real_type bound = N * std::numeric_limits<real_type>::epsilon();
+      for (int i = 0; i < N; ++i) {
+	real_type row = 0;
+	for (int j = 0; j < N; ++j)
+	  row += abs(a[i][j]);
+	bound *= row;
+      }
+      TEST_EXIT(abs(d) > bound)("Matrix is singular, det = " << d << "!\n");
+    }
+    
+  } // end namespace aux
+  /// \endcond
+  
+  
+  /// \brief determinant of a square matrix of size 1x1 to 4x4.
+  /** Evaluated by closed-form cofactor formulas, unrolled and branch free.
+   *  The size of hybrid matrices, e.g. FixMat, WorldMatrix or DimMat, and of
+   *  dynamic matrices is dispatched at runtime to the formula of that size. 
+   *  For static matrices the dispatch is resolved at compile time. Larger
+   *  runtime sizes are an error, also in release builds.
+   **/
+  template <MatrixExpr E>
+  inline traits::compute_type<Value_type<E>> det(E const& A)
+  {
+    typedef traits::compute_type<Value_type<E>> T;
+    static_assert(E::_ROWS <= 4, "Closed-form determinant for matrices up to 4x4 only!");
+    TEST_EXIT(num_rows(A) == num_cols(A) && num_rows(A) <= 4)
+      ("Matrix must be square, of size <= 4!\n");
+    
+    T d{};
+    meta::SWITCH<1, aux::max_inverse_size<E>()>::apply(num_rows(A), [&](auto n) {
+      constexpr int N = decltype(n)::value;
+      T a[N][N];
+      aux::load(A, a);
+      d = aux::determinant(a);
+    });
+    return d;
+  }
+  
+  
+  /// \brief B = A^(-1) for a square matrix A of size 1x1 to 4x4. Returns det(A).
+  /** Same dispatch as \ref det, with the adjugate formulas. A and B may be 
+   *  the same matrix. The \p Mode selects the singularity test, see 
+   *  \ref singular.
+   **/
+  template <MatrixExpr E, Memory_policy M, Singular_mode Mode = singular::ignore>
+  inline traits::compute_type<Value_type<E>> inv(E const& A, M& B, Mode mode = Mode())
+  {
+    typedef traits::compute_type<Value_type<E>> T;
+    static_assert(E::_ROWS <= 4, "Closed-form inverse for matrices up to 4x4 only!");
+    TEST_EXIT(num_rows(A) == num_cols(A) && num_rows(A) <= 4)
+      ("Matrix must be square, of size <= 4!\n");
+    TEST_EXIT(num_rows(B) == num_rows(A) && num_cols(B) == num_cols(A))
+      ("Sizes do not match!\n");
+    
+    T d{};
+    meta::SWITCH<1, aux::max_inverse_size<E>()>::apply(num_rows(A), [&](auto n) {
+      constexpr int N = decltype(n)::value;
+      T a[N][N], b[N][N];
+      aux::load(A, a);
+      d = aux::inverse(a, b);
+      aux::test_singular(a, d, mode);
+      aux::store(b, B);
+    });
+    return d;
+  }
+  
+  /// \brief returns A^(-1) for a square matrix A of size 1x1 to 4x4, see \ref inv.
+  template <Memory_policy M, Singular_mode Mode = singular::ignore>
+    requires MatrixExpr<M>
+  inline M inv(M const& A, Mode mode = Mode())
+  {
+    M B(A);
+    inv(A, B, mode);
+    return B;
+  }
+  
+  
+  namespace functors
+  {
+    /// det(A) of a matrix of type \p M, for batches of matrices
+    template <class M>
+    struct determinant : FunctorBase
+    {
+      typedef traits::compute_type<Value_type<M>> result_type;
+      typedef result_type                          value_type;
+      
+      static result_type apply(M const& A) { return det(A); }
+      result_type operator()(M const& A) const { return det(A); }
+    };
+    
+    /// A^(-1) of a matrix of type \p M, for batches of matrices
+    template <class M>
+    struct inverse : FunctorBase
+    {
+      typedef M result_type;
+      typedef M  value_type;
+      
+      static result_type apply(M const& A) { return inv(A); }
+      result_type operator()(M const& A) const { return inv(A); }
+    };
+    
+  } // end namespace functors
+  
+  
+  namespace traits
+  {
+    /// \cond HIDDEN_SYMBOLS
+    // flops of the cofactor formulas for the (maximal) size of M
+    template <class M>
+    struct functor_flops<functors::determinant<M>> 
+      : int_< AMDiS::aux::determinant_flops(AMDiS::aux::max_inverse_size<M>()) > {};
+    
+    template <class M>
+    struct functor_flops<functors::inverse<M>> 
+      : int_< AMDiS::aux::inverse_flops(AMDiS::aux::max_inverse_size<M>()) > {};
+    /// \endcond
+    
+  } // end namespace traits
+} // end namespace AMDiS
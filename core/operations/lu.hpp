@@ -0,0 +1,253 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file lu.hpp */
+
+#pragma once
+
+#include <cmath>
+#include <utility>	// std::swap
+
+#include "Log.h"			// TEST_EXIT_DBG
+#include "traits/concepts.hpp"
+#include "traits/size.hpp"
+#include "traits/num_rows.hpp"
+#include "traits/num_cols.hpp"
+#include "operations/generic_loops.hpp"	// meta::UNROLL, meta::SWITCH
+
+namespace AMDiS 
+{
+  /// largest static size (or capacity of a hybrid matrix), for which the LU 
+  /// factorization and the solve are fully unrolled
+  static constexpr int LU_UNROLL_SIZE = 16;
+  
+  
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    // ----- unrolled kernels for the size N ----------------------------------
+    
+    template <class M, class P, int N>
+    inline bool lu_factor(M& A, P& pivot, int_<N>)
+    {
+      typedef Value_type<M> T;
+      using std::abs;
+      using meta::UNROLL;
+      
+      bool regular = true;
+      UNROLL<0,N>::apply([&](auto k_) {
+	constexpr int k = decltype(k_)::value;
+	
+	// largest entry of column k on or below the diagonal
+	int r = k;
+	auto max_value = abs(A(k, k));
+	UNROLL<k+1,N>::apply([&](auto i) {
+	  auto const value = abs(A(i, k));
+	  if (value > max_value) {
+	    max_value = value;
+	    r = i;
+	  }
+	});
+	
+	pivot(k) = r;
+	if (r != k)
+	  UNROLL<0,N>::apply([&](auto j) { std::swap(A(k, j), A(r, j)); });
+	regular = regular && max_value != 0;
+	
+	// eliminate column k
+	T const factor = T(1) / A(k, k);
+	UNROLL<k+1,N>::apply([&](auto i) {
+	  T const l = (A(i, k) *= factor);
+	  UNROLL<k+1,N>::apply([&](auto j) { A(i, j) -= l * A(k, j); });
+	});
+      });
+      return regular;
+    }
+    
+    template <class M, class P, class V, int N>
+    inline void lu_solve(M const& A, P const& pivot, V& x, int_<N>)
+    {
+      typedef Value_type<V> T;
+      using meta::UNROLL;
+      
+      UNROLL<0,N>::apply([&](auto k) {
+	if (size_t(pivot(k)) != size_t(k))
+	  std::swap(x(k), x(pivot(k)));
+      });
+      
+      // forward substitution with the unit lower triangle L
+      UNROLL<1,N>::apply([&](auto i_) {
+	constexpr int i = decltype(i_)::value;
+	T value = x(i);
+	UNROLL<0,i>::apply([&](auto j) { value -= A(i, j) * x(j); });
+	x(i) = value;
+      });
+      
+      // backward substitution with U
+      UNROLL<0,N>::apply([&](auto ii) {
+	constexpr int i = N - 1 - decltype(ii)::value;
+	T value = x(i);
+	UNROLL<i+1,N>::apply([&](auto j) { value -= A(i, j) * x(j); });
+	x(i) = value / A(i, i);
+      });
+    }
+    
+    // ----- loops for a runtime size n ----------------------------------------
+    
+    template <class M, class P>
+    inline bool lu_factor(M& A, P& pivot, size_t n)
+    {
+      typedef Value_type<M> T;
+      using std::abs;
+      
+      bool regular = true;
+      for (size_t k = 0; k < n; ++k) {
+	size_t r = k;
+	auto max_value = abs(A(k, k));
+	for (size_t i = k+1; i < n; ++i) {
+	  auto const value = abs(A(i, k));
+	  if (value > max_value) {
+	    max_value = value;
+	    r = i;
+	  }
+	}
+	
+	pivot(k) = r;
+	if (r != k)
+	  for (size_t j = 0; j < n; ++j)
+	    std::swap(A(k, j), A(r, j));
+	regular = regular && max_value != 0;
+	
+	T const factor = T(1) / A(k, k);
+	for (size_t i = k+1; i < n; ++i) {
+	  T const l = (A(i, k) *= factor);
+	  for (size_t j = k+1; j < n; ++j)
+	    A(i, j) -= l * A(k, j);
+	}
+      }
+      return regular;
+    }
+    
+    template <class M, class P, class V>
+    inline void lu_solve(M const& A, P const& pivot, V& x, size_t n)
+    {
+      typedef Value_type<V> T;
+      
+      for (size_t k = 0; k < n; ++k)
+	if (size_t(pivot(k)) != k)
+	  std::swap(x(k), x(pivot(k)));
+	
+      for (size_t i = 1; i < n; ++i) {
+	T value = x(i);
+	for (size_t j = 0; j < i; ++j)
+	  value -= A(i, j) * x(j);
+	x(i) = value;
+      }
+      
+      for (size_t i = n; i-- > 0;) {
+	T value = x(i);
+	for (size_t j = i+1; j < n; ++j)
+	  value -= A(i, j) * x(j);
+	x(i) = value / A(i, i);
+      }
+    }
+    
+    // maximal number of rows of M: the static size, or the capacity of 
+    // hybrid matrices, or -1 for dynamic matrices
+    template <class M>
+    struct max_rows : int_<M::_ROWS> {};
+    
+    template <class M> 
+      requires (M::_ROWS < 0) && requires { M::_MAX_ROWS; }
+    struct max_rows<M> : int_<M::_MAX_ROWS> {};
+    
+    // 0: runtime loops, 1: unrolled kernel of the static size, 
+    // 2: runtime size dispatched to the unrolled kernels up to the capacity
+    template <class M>
+    using lu_kernel = int_<(max_rows<M>::value <= 0 || max_rows<M>::value > LU_UNROLL_SIZE) ? 0 
+			   : (M::_ROWS > 0) ? 1 : 2>;
+    
+    template <class M, class F>
+    inline void lu_dispatch(size_t n, F f, int_<0>)
+    {
+      f(n);
+    }
+    
+    template <class M, class F>
+    inline void lu_dispatch(size_t, F f, int_<1>)
+    {
+      f(int_<M::_ROWS>());
+    }
+    
+    template <class M, class F>
+    inline void lu_dispatch(size_t n, F f, int_<2>)
+    {
+      meta::SWITCH<1, max_rows<M>::value>::apply(n, f);
+    }
+    
+  } // end namespace aux
+  /// \endcond
+  
+  
+  /// \brief LU factorization with partial pivoting, in place: P*A = L*U.
+  /** On return, the strict lower triangle of \p A contains L (with unit 
+   *  diagonal, not stored) and the upper triangle contains U. Row k was 
+   *  swapped with row pivot(k) >= k in step k. Returns false, if A is 
+   *  singular, i.e. a pivot is zero.
+   *  
+   *  For static matrices up to LU_UNROLL_SIZE the factorization is fully 
+   *  unrolled and allocation-free, e.g. with a StaticMatrix and a 
+   *  StaticVector<int, N> of pivots. For hybrid matrices, e.g. FixMat or 
+   *  WorldMatrix, with a capacity up to LU_UNROLL_SIZE the runtime size is 
+   *  dispatched to the unrolled kernel of that size. Dynamic matrices use 
+   *  runtime loops. The factorization can be used for any number of 
+   *  right-hand sides, see \ref lu_solve.
+   **/
+  template <Memory_policy M, Memory_policy P>
+    requires MatrixExpr<M> && Integral<Value_type<P>>
+  inline bool lu(M& A, P& pivot)
+  {
+    TEST_EXIT_DBG(num_rows(A) == num_cols(A))("Matrix must be square!\n");
+    TEST_EXIT_DBG(size(pivot) >= num_rows(A))("Pivot vector too small!\n");
+    
+    bool regular = true;
+    aux::lu_dispatch<M>(num_rows(A), [&](auto n) { regular = aux::lu_factor(A, pivot, n); }, 
+			aux::lu_kernel<M>());
+    return regular;
+  }
+  
+  
+  /// \brief solves A*x = b with the factorization of \ref lu, in place: on 
+  /// input \p x contains the right-hand side b, on return the solution.
+  template <Memory_policy M, Memory_policy P, Memory_policy V>
+    requires MatrixExpr<M> && Integral<Value_type<P>> && VectorExpr<V>
+  inline void lu_solve(M const& A, P const& pivot, V& x)
+  {
+    TEST_EXIT_DBG(num_rows(A) == num_cols(A))("Matrix must be square!\n");
+    TEST_EXIT_DBG(size(pivot) >= num_rows(A))("Pivot vector too small!\n");
+    TEST_EXIT_DBG(size(x) == num_rows(A))("Sizes do not match!\n");
+    
+    aux::lu_dispatch<M>(num_rows(A), [&](auto n) { aux::lu_solve(A, pivot, x, n); }, 
+			aux::lu_kernel<M>());
+  }
+  
+} // end namespace AMDiS
@@ -0,0 +1,395 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file packet.hpp */
+
+#pragma once
+
+#include <cstring>	// std::memcpy
+#include <utility>	// std::declval
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>	// hardware gather
+#endif
+
+#include "Config.h"			// SIMD_BYTES
+#include "traits/concepts.hpp"
+#include "operations/generic_loops.hpp"	// meta::UNROLL, meta::BLOCKED
+#include "operations/functors.hpp"	// functors::plus, ...
+
+// Packets wider than SIMD_BYTES are returned by inline functions, that are
+// inlined into the kernels compiled for the corresponding instruction set,
+// see cpu_dispatch.hpp. The ABI of non-inlined calls is not relevant.
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace AMDiS 
+{
+  namespace simd
+  {
+    /// \brief SIMD packet of \p Bytes width for the value type \p T.
+    /** Uses the vector extension of GCC and Clang, so that the arithmetic 
+     *  operators work on all elements of the packet. Types without a packet
+     *  type have a packet size of 1 and are not accessed by packets. The 
+     *  width is SIMD_BYTES, except in the kernels of cpu_dispatch.hpp, that
+     *  use the native width of the instruction set they are compiled for.
+     **/
+    template <class T, int Bytes = SIMD_BYTES>
+    struct packet_traits
+    {
+      typedef T type;
+      static constexpr int size = 1;
+    };
+    
+#if defined(__GNUC__)
+    template <int Bytes>
+    struct packet_traits<float, Bytes>
+    {
+      typedef float type __attribute__((vector_size(Bytes)));
+      static constexpr int size = Bytes / sizeof(float);
+    };
+    
+    template <int Bytes>
+    struct packet_traits<double, Bytes>
+    {
+      typedef double type __attribute__((vector_size(Bytes)));
+      static constexpr int size = Bytes / sizeof(double);
+    };
+#endif
+    
+    template <class T, int Bytes = SIMD_BYTES>
+    using Packet = typename packet_traits<T, Bytes>::type;
+    
+    
+    /// \brief expressions of value type \p T, that provide packet access
+    template <class E, class T>
+    concept bool Packet_access = Packet_expression<E> && 
+      std::is_same<Value_type<E>, T>::value && (packet_traits<T>::size > 1);
+    
+    /// \brief result of the comparison of two packets of type \p T.
+    /** An integer packet of the same width, with all bits set in the lanes 
+     *  where the comparison is true. For types without packets it is bool.
+     **/
+    template <class T, int Bytes = SIMD_BYTES>
+    using Mask = decltype( Packet<T, Bytes>() < Packet<T, Bytes>() );
+    
+    
+    /// \brief mask expressions, that provide the comparison results of the 
+    /// elements [i, i+W) as Mask<T> by expr.mask(i)
+    template <class E, class T>
+    concept bool Mask_access = ExpressionBase<E> && 
+      requires(E expr, Size_type<E> i) { expr.mask(i); } &&
+      std::is_same<decltype(std::declval<E const&>().mask(Size_type<E>())), Mask<T>>::value &&
+      (packet_traits<T>::size > 1);
+    
+    
+    /// load a packet from (unaligned) memory
+    template <int Bytes = SIMD_BYTES, class T>
+    inline Packet<T, Bytes> load(T const* p)
+    {
+      Packet<T, Bytes> x;
+      std::memcpy(&x, p, sizeof(x));
+      return x;
+    }
+    
+    /// store a packet to (unaligned) memory
+    template <class T, class P>
+    inline void store(T* p, P const& x)
+    {
+      std::memcpy(p, &x, sizeof(x));
+    }
+    
+    /// gather a packet (base[idx[0]], ..., base[idx[W-1]]) from the 
+    /// positions given by an index array.
+    template <int Bytes = SIMD_BYTES, class T, class I>
+    inline Packet<T, Bytes> gather(T const* base, I const* idx, int_<Bytes> = {})
+    {
+      Packet<T, Bytes> x;
+      meta::UNROLL<0, packet_traits<T, Bytes>::size>::apply([&](auto k) { x[int(k)] = base[idx[k]]; });
+      return x;
+    }
+    
+    /// \cond HIDDEN_SYMBOLS
+    // hardware gather instructions for 32 and 64 bit indices
+#if defined(__AVX512F__) && SIMD_BYTES == 64
+    inline Packet<double> gather(double const* base, int const* idx, int_<SIMD_BYTES> = {})
+    {
+      return _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(idx)), base, 8);
+    }
+    
+    inline Packet<double> gather(double const* base, long const* idx, int_<SIMD_BYTES> = {})
+    {
+      return _mm512_i64gather_pd(_mm512_loadu_si512(idx), base, 8);
+    }
+    
+    inline Packet<float> gather(float const* base, int const* idx, int_<SIMD_BYTES> = {})
+    {
+      return _mm512_i32gather_ps(_mm512_loadu_si512(idx), base, 4);
+    }
+#elif defined(__AVX2__) && SIMD_BYTES == 32
+    inline Packet<double> gather(double const* base, int const* idx, int_<SIMD_BYTES> = {})
+    {
+      return _mm256_i32gather_pd(base, _mm_loadu_si128(reinterpret_cast<__m128i const*>(idx)), 8);
+    }
+    
+    inline Packet<double> gather(double const* base, long const* idx, int_<SIMD_BYTES> = {})
+    {
+      return _mm256_i64gather_pd(base, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(idx)), 8);
+    }
+    
+    inline Packet<float> gather(float const* base, int const* idx, int_<SIMD_BYTES> = {})
+    {
+      return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(idx)), 4);
+    }
+#endif
+    /// \endcond
+    
+    /// packet with all elements equal to \p value
+    template <int Bytes = SIMD_BYTES, class T>
+    inline Packet<T, Bytes> broadcast(T const& value)
+    {
+      Packet<T, Bytes> x;
+      meta::UNROLL<0, packet_traits<T, Bytes>::size>::apply([&](auto k) { x[int(k)] = value; });
+      return x;
+    }
+    
+    
+    /// blend of two packets: a in the lanes where the mask \p m is set, b otherwise
+    template <class M, class P>
+    inline P select(M const& m, P const& a, P const& b)
+    {
+      return m ? a : b;
+    }
+    
+    
+    /// \brief mapping of a static functor to its packet version.
+    /** The packet version is available, if packet_functor<F>::value is true.
+     **/
+    template <class F>
+    struct packet_functor : false_ {};
+    
+    /// \cond HIDDEN_SYMBOLS
+    template <class T1, class T2>
+    struct packet_functor<functors::plus<T1, T2>> : true_
+    {
+      template <class P>
+      static P apply(P const& a, P const& b) { return a + b; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::minus<T1, T2>> : true_
+    {
+      template <class P>
+      static P apply(P const& a, P const& b) { return a - b; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::times<T1, T2>> : true_
+    {
+      template <class P>
+      static P apply(P const& a, P const& b) { return a * b; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::divide<T1, T2>> : true_
+    {
+      template <class P>
+      static P apply(P const& a, P const& b) { return a / b; }
+    };
+    
+    template <class T>
+    struct packet_functor<functors::negate<T>> : true_
+    {
+      template <class P>
+      static P apply(P const& a) { return -a; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::less<T1, T2>> : true_
+    {
+      template <class P>
+      static auto apply(P const& a, P const& b) { return a < b; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::less_equal<T1, T2>> : true_
+    {
+      template <class P>
+      static auto apply(P const& a, P const& b) { return a <= b; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::greater<T1, T2>> : true_
+    {
+      template <class P>
+      static auto apply(P const& a, P const& b) { return a > b; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::greater_equal<T1, T2>> : true_
+    {
+      template <class P>
+      static auto apply(P const& a, P const& b) { return a >= b; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::equal_to<T1, T2>> : true_
+    {
+      template <class P>
+      static auto apply(P const& a, P const& b) { return a == b; }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::not_equal_to<T1, T2>> : true_
+    {
+      template <class P>
+      static auto apply(P const& a, P const& b) { return a != b; }
+    };
+    /// \endcond
+    
+    
+    /// a[i] = src(i) (or compound assignment given by the Assigner) for i in 
+    /// [0, n) by packets of \p Bytes width. Returns the first index of the 
+    /// scalar tail.
+    template <int Bytes = SIMD_BYTES, class T, class Source, class Assigner>
+    inline size_t assign(T* a, Source const& src, size_t n, Assigner)
+    {
+      constexpr size_t W = packet_traits<T, Bytes>::size;
+      
+      size_t i = 0;
+      for (; i + W <= n; i += W) {
+	Packet<T, Bytes> x = load<Bytes>(a + i);
+	Assigner::apply(x, src.template packet<Bytes>(i));
+	store(a + i, x);
+      }
+      return i;
+    }
+    
+    /// same as \ref assign, for a compile-time size \p N, i.e. N / W unrolled
+    /// packets. The tail [N - N % W, N) must be assigned by the caller.
+    template <long N, class T, class Source, class Assigner>
+    inline void assign(T* a, Source const& src, Assigner)
+    {
+      constexpr long W = packet_traits<T>::size;
+      
+      meta::UNROLL<0, N / W>::apply([&](auto p) {
+	Packet<T> x = load(a + p*W);
+	Assigner::apply(x, src.packet(p*W));
+	store(a + p*W, x);
+      });
+    }
+    
+    
+    /// \brief packet version of a reduction functor \p F.
+    /** Provides update(acc, x) (or update(acc, x, y) for binary reductions)
+     *  and finish(acc, acc2) for packet accumulators, that are initialized 
+     *  by a broadcast of F::init. Available, if packet_reduction<F>::value 
+     *  is true.
+     **/
+    template <class F>
+    struct packet_reduction : false_ {};
+    
+    /// \brief reduction functors \p F with a packet version for the 
+    /// accumulator type \p T
+    template <class F, class T>
+    concept bool Packet_reduction = packet_reduction<F>::value && 
+      std::is_same<Accumulator_type<F>, T>::value && (packet_traits<T>::size > 1);
+    
+    
+    /// \brief reduction of a runtime number of elements by packets.
+    /** Like meta::BLOCKED, but the accumulators are \p P packets of \p Bytes
+     *  width, i.e. the loop carries P independent packet accumulators in 
+     *  registers. The packets and afterwards the lanes are combined pairwise.
+     *  Requires a \ref packet_reduction for the Functor.
+     **/
+    template <long P, int Bytes = SIMD_BYTES>
+    struct BLOCKED
+    {
+      /// result = reduce_i{ f(a_i) }, i in [0, n)
+      template <class A, class T, class Functor>
+      static void accumulate(A const& a, size_t n, T& result, Functor f)
+      {
+	constexpr long W = packet_traits<T, Bytes>::size;
+	using meta::UNROLL;
+	typedef packet_reduction<Functor> PF;
+	
+	Packet<T, Bytes> acc[P];
+	init<T>(acc, f);
+	
+	size_t i = 0;
+	for (; i + P*W <= n; i += P*W)
+	  UNROLL<0,P>::apply([&](auto p) { PF::update(acc[p], a.template packet<Bytes>(i + p*W)); });
+	
+	combine(acc, result, f);
+	for (; i < n; ++i)
+	  Functor::update(result, a(i));
+      }
+      
+      /// result = reduce_i{ f(a_i, b_i) }, i in [0, n)
+      template <class A, class B, class T, class Functor>
+      static void inner_product(A const& a, B const& b, size_t n, T& result, Functor f)
+      {
+	constexpr long W = packet_traits<T, Bytes>::size;
+	using meta::UNROLL;
+	typedef packet_reduction<Functor> PF;
+	
+	Packet<T, Bytes> acc[P];
+	init<T>(acc, f);
+	
+	size_t i = 0;
+	for (; i + P*W <= n; i += P*W)
+	  UNROLL<0,P>::apply([&](auto p) { 
+	    PF::update(acc[p], a.template packet<Bytes>(i + p*W), b.template packet<Bytes>(i + p*W)); 
+	  });
+	
+	combine(acc, result, f);
+	for (; i < n; ++i)
+	  Functor::update(result, a(i), b(i));
+      }
+      
+    private:
+      // all lanes of the packet accumulators are set to the value of Functor::init
+      template <class T, class Functor>
+      static void init(Packet<T, Bytes> (&acc)[P], Functor)
+      {
+	T value;
+	Functor::init(value);
+	meta::UNROLL<0,P>::apply([&](auto p) { acc[p] = broadcast<Bytes>(value); });
+      }
+      
+      // horizontal reduction of the packets and of the lanes
+      template <class T, class Functor>
+      static void combine(Packet<T, Bytes> (&acc)[P], T& result, Functor f)
+      {
+	constexpr long W = packet_traits<T, Bytes>::size;
+	meta::BLOCKED<P>::combine(acc, packet_reduction<Functor>());
+	
+	T lanes[W];
+	meta::UNROLL<0,W>::apply([&](auto k) { lanes[k] = acc[0][int(k)]; });
+	meta::BLOCKED<W>::combine(lanes, f);
+	result = lanes[0];
+      }
+    };
+    
+  } // end namespace simd
+} // end namespace AMDiS
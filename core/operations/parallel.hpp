@@ -0,0 +1,198 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file parallel.hpp */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Config.h"			// CACHE_LINE_SIZE, PARALLEL_MIN_WORK, REDUCTION_CHUNK_SIZE
+#include "traits/concepts.hpp"
+#include "traits/eval_cost.hpp"		// traits::expr_cost
+#include "operations/packet.hpp"		// simd::Packet_access
+#include "utility/thread_pool.hpp"
+
+namespace AMDiS 
+{
+  namespace parallel
+  {
+    /// \brief true, if \p n evaluations of an element with the cost model 
+    /// \p C, i.e. flops, loads and stores, plus \p stores stores of the 
+    /// result, reach PARALLEL_MIN_WORK, and the pool has several threads.
+    template <class C>
+    inline bool enough_work(size_t n, int stores)
+    {
+      return n * (C::flops + C::loads + C::stores + stores) >= PARALLEL_MIN_WORK && 
+	     ThreadPool::instance().size() > 1;
+    }
+    
+    /// \brief true_, if sizeof(T) divides CACHE_LINE_SIZE, i.e. if arrays of
+    /// \p T can be partitioned into cache lines, see \ref for_blocks.
+    template <class T>
+    using cache_line_partition = bool_<(CACHE_LINE_SIZE % sizeof(T) == 0)>;
+    
+    /// \brief true, if the assignment of the expression \p Source to \p n 
+    /// elements of type \p T is worth the distribution to the thread pool.
+    /** The work is estimated by the cost model traits::expr_cost, i.e. 
+     *  flops, loads and the store of the target, and compared with 
+     *  PARALLEL_MIN_WORK. Only for types with a \ref cache_line_partition.
+     **/
+    template <class T, class Source>
+      requires cache_line_partition<T>::value
+    inline bool use_threads(size_t n)
+    {
+      return enough_work<traits::expr_cost<Source>>(n, 1);
+    }
+    
+    
+    /// \brief call kernel(begin, end) for disjoint blocks [begin, end) of 
+    /// the array \p data of size \p n, in parallel by the thread pool.
+    /** All blocks, except the first one, start at a cache line, so that no
+     *  two threads write to the same cache line (no false sharing). There 
+     *  are about 4 blocks per thread, for load balancing.
+     **/
+    template <class T, class Kernel>
+      requires cache_line_partition<T>::value
+    void for_blocks(T const* data, size_t n, Kernel const& kernel)
+    {
+      constexpr size_t line = CACHE_LINE_SIZE / sizeof(T);
+      
+      ThreadPool& pool = ThreadPool::instance();
+      
+      // number of elements before the first cache line boundary
+      size_t const misalignment = std::uintptr_t(data) % CACHE_LINE_SIZE;
+      size_t const head = (misalignment % sizeof(T) == 0) 
+	? ((CACHE_LINE_SIZE - misalignment) % CACHE_LINE_SIZE) / sizeof(T) : 0;
+      if (n <= head + line) {
+	kernel(size_t(0), n);
+	return;
+      }
+      
+      // block length: a multiple of the cache line
+      size_t const num_blocks = 4 * pool.size();
+      size_t const block = ((n - head + num_blocks - 1) / num_blocks + line - 1) / line * line;
+      size_t const m = (n - head + block - 1) / block;
+      
+      pool.parallel_for(m, [&](size_t k) {
+	size_t const begin = k == 0 ? 0 : head + k * block;
+	size_t const end = std::min(n, head + (k + 1) * block);
+	kernel(begin, end);
+      });
+    }
+    
+    
+    /// \brief deterministic reduction of \p n elements, with the partial 
+    /// results of the chunks combined by Functor::finish.
+    /** The range [0, n) is split into chunks of REDUCTION_CHUNK_SIZE elements
+     *  and kernel(begin, end, result) reduces a chunk. The partial results 
+     *  are combined pairwise in a fixed tree, i.e. ((r0+r1)+(r2+r3))+..., so
+     *  the result depends on n only, not on the number of threads or the 
+     *  order in which the chunks are processed. The chunks are distributed 
+     *  to the thread pool, if the work, estimated by the cost model \p C of 
+     *  an element, reaches PARALLEL_MIN_WORK.
+     **/
+    template <class C, class T, class Functor, class Kernel>
+    T reduce(size_t n, Kernel const& kernel, Functor)
+    {
+      size_t const m = (n + REDUCTION_CHUNK_SIZE - 1) / REDUCTION_CHUNK_SIZE;
+      if (m <= 1) {
+	T result;
+	kernel(size_t(0), n, result);
+	return result;
+      }
+      
+      // an array instead of std::vector<T>, since std::vector<bool> packs bits
+      std::unique_ptr<T[]> partial(new T[m]);
+      auto chunk = [&](size_t k) {
+	size_t const begin = k * REDUCTION_CHUNK_SIZE;
+	kernel(begin, std::min(n, begin + REDUCTION_CHUNK_SIZE), partial[k]);
+      };
+      
+      if (enough_work<C>(n, 0))
+	ThreadPool::instance().parallel_for(m, chunk);
+      else
+	for (size_t k = 0; k < m; ++k)
+	  chunk(k);
+      
+      // pairwise combination in a tree, that depends on m only
+      for (size_t stride = 1; stride < m; stride *= 2)
+	for (size_t k = 0; k + stride < m; k += 2 * stride)
+	  Functor::finish(partial[k], partial[k + stride]);
+      return partial[0];
+    }
+    
+    
+    /// \brief view of the elements [offset, ...) of an expression \p E, 
+    /// i.e. shifted(expr, o)(i) == expr(o + i), used to evaluate an 
+    /// expression on a block of the target by the dynamic-size kernels.
+    template <class E>
+    struct ShiftedExpr
+    {
+      typedef Value_type<E>  value_type;
+      typedef size_t          size_type;
+      
+      static constexpr int _SIZE = -1;
+      static constexpr int _ROWS = -1;
+      static constexpr int _COLS = -1;
+      
+      ShiftedExpr(E const& expr, size_t offset) 
+	: expr(expr), offset(offset) 
+      { }
+      
+      /// access the elements of an expr.
+      value_type operator()(size_type i) const
+      {
+	return expr(offset + i);
+      }
+      
+      /// access the elements [i, i+W) of an expr. as SIMD packet.
+      template <int Bytes = SIMD_BYTES>
+      simd::Packet<value_type, Bytes> packet(size_type i) const
+	requires simd::Packet_access<E, value_type>
+      {
+	return expr.template packet<Bytes>(offset + i);
+      }
+      
+      /// pointer to the elements of a container, starting at the offset
+      auto data() const
+	requires requires(E const& e) { e.data(); }
+      {
+	return expr.data() + offset;
+      }
+      
+    private:
+      E const& expr;
+      size_t offset;
+    };
+    
+    template <class E>
+    inline ShiftedExpr<E> shifted(E const& expr, size_t offset)
+    {
+      return ShiftedExpr<E>(expr, offset);
+    }
+    
+  } // end namespace parallel
+} // end namespace AMDiS
@@ -0,0 +1,169 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file reduce_all.hpp */
+
+#pragma once
+
+#include <tuple>	// std::tuple, std::get
+#include <utility>	// std::index_sequence
+
+#include "traits/concepts.hpp"
+#include "operations/meta.hpp"
+#include "expressions/reduction_unary_expr.hpp"
+#include "expressions/reduction_binary_expr.hpp"
+
+namespace AMDiS 
+{
+  namespace functors
+  {
+    /// \cond HIDDEN_SYMBOLS
+    namespace aux
+    {
+      // binary reduction functors are updated with both arguments
+      template <class F, class T, class X, class Y>
+	requires requires(T& value, X const& x, Y const& y) { F::update(value, x, y); }
+      inline int update_reduction(T& value, X const& x, Y const& y) 
+      { 
+	F::update(value, x, y); 
+	return 0; 
+      }
+      
+      // unary reduction functors are updated with the first argument only
+      template <class F, class T, class X, class Y>
+      inline int update_reduction(T& value, X const& x, Y const&) 
+      { 
+	F::update(value, x); 
+	return 0; 
+      }
+      
+    } // end namespace aux
+    /// \endcond
+    
+    
+    /// \brief Reduction functor, that applies all reduction functors \p Fs 
+    /// to the same elements.
+    /** The accumulator is the tuple of the accumulators of the Fs, the 
+     *  result the tuple of their results. For two arguments, binary 
+     *  functors are updated with (x, y), unary functors with x only. Used 
+     *  by \ref reduce_all, so that the fused reduction is evaluated by the
+     *  same kernels as a single one, i.e. unrolled for static sizes and 
+     *  with several independent accumulators and in chunks otherwise.
+     **/
+    template <class... Fs>
+    struct fused_reduction_functor
+    {
+      typedef std::tuple<Result_type<Fs>...>            result_type;
+      typedef std::tuple<Accumulator_type<Fs>...>  accumulator_type;
+      
+      static inline void init(accumulator_type& value)
+      {
+	init(value, std::index_sequence_for<Fs...>());
+      }
+      
+      template <typename Element>
+      static inline void update(accumulator_type& value, const Element& x)
+      {
+	update(value, x, std::index_sequence_for<Fs...>());
+      }
+      
+      template <typename Element1, typename Element2>
+      static inline void update(accumulator_type& value, const Element1& x, const Element2& y)
+      {
+	update(value, x, y, std::index_sequence_for<Fs...>());
+      }
+      
+      static inline void finish(accumulator_type& value, const accumulator_type& value2)
+      {
+	finish(value, value2, std::index_sequence_for<Fs...>());
+      }
+      
+      static inline result_type post_reduction(const accumulator_type& value)
+      {
+	return post_reduction(value, std::index_sequence_for<Fs...>());
+      }
+      
+    private:
+      template <size_t... I>
+      static void init(accumulator_type& value, std::index_sequence<I...>)
+      {
+	int init[] = { 0, (Fs::init(std::get<I>(value)), 0)... };  (void)init;
+      }
+      
+      template <typename Element, size_t... I>
+      static void update(accumulator_type& value, const Element& x, std::index_sequence<I...>)
+      {
+	int update[] = { 0, (Fs::update(std::get<I>(value), x), 0)... };  (void)update;
+      }
+      
+      template <typename Element1, typename Element2, size_t... I>
+      static void update(accumulator_type& value, const Element1& x, const Element2& y, 
+			 std::index_sequence<I...>)
+      {
+	int update[] = { 0, aux::update_reduction<Fs>(std::get<I>(value), x, y)... };  (void)update;
+      }
+      
+      template <size_t... I>
+      static void finish(accumulator_type& value, const accumulator_type& value2, std::index_sequence<I...>)
+      {
+	int finish[] = { 0, (Fs::finish(std::get<I>(value), std::get<I>(value2)), 0)... };  (void)finish;
+      }
+      
+      template <size_t... I>
+      static result_type post_reduction(const accumulator_type& value, std::index_sequence<I...>)
+      {
+	return result_type(Fs::post_reduction(std::get<I>(value))...);
+      }
+    };
+    
+  } // end namespace functors
+  
+  
+  /// \brief Evaluates several reductions of \p expr in one traversal.
+  /** Each element of the expression is evaluated once and passed to all 
+   *  reduction functors. Returns a tuple of the results, e.g.
+   *  std::tie(s, n, m) = reduce_all(v, sum_reduction_functor<T>(), 
+   *                            two_norm_functor<T>(), max_reduction_functor<T>());
+   **/
+  template <Expression E, class... Fs>
+    requires (sizeof...(Fs) > 0) && and_c< (Reduction_sfunctor<Fs, Value_type<E>>)... >::value
+  std::tuple<Result_type<Fs>...> reduce_all(E const& expr, Fs...)
+  {
+    return ReductionUnaryExpr<E, functors::fused_reduction_functor<Fs...>>(expr);
+  }
+  
+  
+  /// \brief Evaluates several reductions of \p expr1 and \p expr2 in one traversal.
+  /** Binary reduction functors are applied to (expr1(i), expr2(i)), unary 
+   *  reduction functors to expr1(i) only, e.g. for the CG method:
+   *  std::tie(rr, rz) = reduce_all(r, z, unary_dot_functor<T>(), dot_functor<T,T>());
+   **/
+  template <Expression E1, Expression E2, class... Fs>
+    requires (sizeof...(Fs) > 0) && 
+      and_c< (Reduction_sfunctor<Fs, Value_type<E1>, Value_type<E2>> || 
+	      Reduction_sfunctor<Fs, Value_type<E1>>)... >::value
+  std::tuple<Result_type<Fs>...> reduce_all(E1 const& expr1, E2 const& expr2, Fs...)
+  {
+    return ReductionBinaryExpr<E1, E2, functors::fused_reduction_functor<Fs...>>(expr1, expr2);
+  }
+  
+} // end namespace AMDiS
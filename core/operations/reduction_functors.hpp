@@ -36,6 +36,7 @@
 
 #include "operations/functors.hpp"
 #include "operations/assign.hpp"
+#include "operations/packet.hpp"	// simd::packet_reduction
 
 namespace AMDiS {
 
@@ -161,12 +162,26 @@ namespace AMDiS {
 	using math::zero;
 	value= zero(value);
       }
+      
+      // real values: usable in constant expressions
+      template <Arithmetic Value>
+      static constexpr void init(Value& value)
+      {
+	value= Value(0);
+      }
 
       template <typename Value, typename Element1, typename Element2>
       static inline void update(Value& value, const Element1& x, const Element2& y)
       {    
 	value+= ConjOp()(x) * y;
       }
+      
+      // real values: the conjugation is the identity
+      template <Arithmetic Value, Arithmetic Element1, Arithmetic Element2>
+      static constexpr void update(Value& value, const Element1& x, const Element2& y)
+      {    
+	value+= x * y;
+      }
 
       template <typename Value>
       static inline void finish(Value& value, const Value& value2, const Value& value3)
@@ -174,8 +189,15 @@ namespace AMDiS {
 	value+= ConjOp()(value2) * value3;
       }
 
+      // combine partial results
       template <typename Value>
-      static inline Value post_reduction(const Value& value)
+      static constexpr void finish(Value& value, const Value& value2)
+      {
+	value+= value2;
+      }
+
+      template <typename Value>
+      static constexpr Value post_reduction(const Value& value)
       {
 	return value;
       }
@@ -212,31 +234,31 @@ namespace AMDiS {
       typedef ResultType result_type;
       
       template <class Value>
-      static inline void init(Value& value)
+      static constexpr void init(Value& value)
       {
-	InitAssign op;
+	InitAssign op{};
 	op(value);
       }
 
       template <class Value, class Element>
-      static inline void update(Value& value, const Element& x)
+      static constexpr void update(Value& value, const Element& x)
       {   
-	UpdateAssign op;
+	UpdateAssign op{};
 	op(value, x);
       }
 
       template <class Value>
-      static inline void finish(Value& value, const Value& value2)
+      static constexpr void finish(Value& value, const Value& value2)
       {
-	FinishAssign op;
+	FinishAssign op{};
 	op(value, value2);
       }
 
       // After reduction compute square root
       template <class Value>
-      static inline Value post_reduction(const Value& value)
+      static constexpr Value post_reduction(const Value& value)
       {
-	PostOp op;
+	PostOp op{};
 	return op(value);
       }
     };
@@ -279,5 +301,110 @@ namespace AMDiS {
 	general_unary_reduction_functor<T, 
 	    AMDiS::assign::ct_value<T, int, 1>, AMDiS::assign::multiplies<T> >;
 	
+    // b0 || b1 || b2 || ...
+    using any_reduction_functor =
+	general_unary_reduction_functor<bool, 
+	    AMDiS::assign::ct_value<bool, bool, false>, AMDiS::assign::logical_or<bool> >;
+	
+    // b0 && b1 && b2 && ...
+    using all_reduction_functor =
+	general_unary_reduction_functor<bool, 
+	    AMDiS::assign::ct_value<bool, bool, true>, AMDiS::assign::logical_and<bool> >;
+	
+    // number of true elements b_i
+    template <class T>
+    using count_reduction_functor =
+	general_unary_reduction_functor<T, 
+	    AMDiS::assign::ct_value<T, int, 0>, AMDiS::assign::plus<T> >;
+	
   } // end namespace functors
+  
+  
+  namespace simd
+  {
+    /// \cond HIDDEN_SYMBOLS
+    namespace aux
+    {
+      template <class P>
+      inline P abs_packet(P const& x) { return x < P{} ? -x : x; }
+      
+      template <class P>
+      inline P max_packet(P const& a, P const& b) { return a < b ? b : a; }
+      
+      template <class P>
+      inline P min_packet(P const& a, P const& b) { return b < a ? b : a; }
+      
+    } // end namespace aux
+    
+    // packet accumulators of the reduction functors, see simd::BLOCKED
+    template <class T>
+    struct packet_reduction<functors::sum_reduction_functor<T>> : true_
+    {
+      template <class P> static void update(P& value, P const& x) { value += x; }
+      template <class P> static void finish(P& value, P const& value2) { value += value2; }
+    };
+    
+    template <class T>
+    struct packet_reduction<functors::prod_reduction_functor<T>> : true_
+    {
+      template <class P> static void update(P& value, P const& x) { value *= x; }
+      template <class P> static void finish(P& value, P const& value2) { value *= value2; }
+    };
+    
+    template <class T>
+    struct packet_reduction<functors::max_reduction_functor<T>> : true_
+    {
+      template <class P> static void update(P& value, P const& x) { value = aux::max_packet(value, x); }
+      template <class P> static void finish(P& value, P const& value2) { value = aux::max_packet(value, value2); }
+    };
+    
+    template <class T>
+    struct packet_reduction<functors::min_reduction_functor<T>> : true_
+    {
+      template <class P> static void update(P& value, P const& x) { value = aux::min_packet(value, x); }
+      template <class P> static void finish(P& value, P const& value2) { value = aux::min_packet(value, value2); }
+    };
+    
+    template <class T>
+    struct packet_reduction<functors::abs_max_reduction_functor<T>> : true_
+    {
+      template <class P> static void update(P& value, P const& x) { value = aux::max_packet(value, aux::abs_packet(x)); }
+      template <class P> static void finish(P& value, P const& value2) { value = aux::max_packet(value, value2); }
+    };
+    
+    template <class T>
+    struct packet_reduction<functors::abs_min_reduction_functor<T>> : true_
+    {
+      template <class P> static void update(P& value, P const& x) { value = aux::min_packet(value, aux::abs_packet(x)); }
+      template <class P> static void finish(P& value, P const& value2) { value = aux::min_packet(value, value2); }
+    };
+    
+    template <class T>
+    struct packet_reduction<functors::one_norm_functor<T>> : true_
+    {
+      template <class P> static void update(P& value, P const& x) { value += aux::abs_packet(x); }
+      template <class P> static void finish(P& value, P const& value2) { value += value2; }
+    };
+    
+    template <class T>
+    struct packet_reduction<functors::two_norm_functor<T>> : true_
+    {
+      template <class P> static void update(P& value, P const& x) { value += x * x; }
+      template <class P> static void finish(P& value, P const& value2) { value += value2; }
+    };
+    
+    template <class T>
+    struct packet_reduction<functors::unary_dot_functor<T>> 
+      : packet_reduction<functors::two_norm_functor<T>> {};
+    
+    // packets of real values only, i.e. the conjugation is the identity
+    template <class A, class B, class ConjOp>
+    struct packet_reduction<functors::dot_functor_aux<A, B, ConjOp>> : true_
+    {
+      template <class P> static void update(P& value, P const& x, P const& y) { value += x * y; }
+      template <class P> static void finish(P& value, P const& value2) { value += value2; }
+    };
+    /// \endcond
+    
+  } // end namespace simd
 } // end namespace AMDiS
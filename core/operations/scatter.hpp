@@ -0,0 +1,192 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file scatter.hpp */
+
+#pragma once
+
+#include <algorithm>	// std::min
+#include <cstdint>	// std::uintptr_t
+#include <mutex>	// std::mutex, std::lock_guard
+#include <thread>	// std::thread::hardware_concurrency
+#include <type_traits>	// std::is_same
+#include <vector>	// std::vector
+
+#include "traits/concepts.hpp"
+#include "traits/size.hpp"
+#include "Log.h"			// TEST_EXIT_DBG
+#include "operations/assign.hpp"	// assign::plus
+#include "utility/thread_pool.hpp"	// ThreadPool
+
+namespace AMDiS 
+{
+  /// \brief modes of the scatter of element contributions into a global 
+  /// container, i.e. global[idx[k]] += local[k].
+  namespace scatter
+  {
+    /// plain update, for a single thread
+    struct serial {};
+    
+    /// lock-free compare-and-swap update, for any number of threads that
+    /// write to the same entries concurrently. Types without lock-free 
+    /// compare-and-swap, e.g. long double, are updated under a lock.
+    struct atomic {};
+    
+    /// plain update, for threads that write to disjoint entries only, 
+    /// e.g. elements of the same colour of a colouring of the mesh
+    struct coloured {};
+    
+  } // end namespace scatter
+  
+  
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    template <class T, class Assigner, class Mode>
+    inline void scatter_update(T& v, T const& v0, Assigner, Mode)
+    {
+      Assigner::apply(v, v0);
+    }
+    
+    // the update is protected by one of a fixed set of mutexes, selected 
+    // by the address of the entry
+    template <class T, class Assigner>
+    inline void scatter_update(T& v, T const& v0, Assigner, scatter::atomic)
+    {
+      static std::mutex locks[64];
+      std::lock_guard<std::mutex> guard(locks[(reinterpret_cast<std::uintptr_t>(&v) / sizeof(T)) % 64]);
+      Assigner::apply(v, v0);
+    }
+    
+    // retry, until no other thread has modified v in between
+    template <class T, class Assigner>
+      requires std::is_trivially_copyable<T>::value && (__atomic_always_lock_free(sizeof(T), 0))
+    inline void scatter_update(T& v, T const& v0, Assigner, scatter::atomic)
+    {
+      T expected, desired;
+      __atomic_load(&v, &expected, __ATOMIC_RELAXED);
+      do {
+	desired = expected;
+	Assigner::apply(desired, v0);
+      } while (!__atomic_compare_exchange(&v, &expected, &desired, true, 
+					   __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    }
+    
+  } // end namespace aux
+  /// \endcond
+  
+  
+  /// \brief global[idx[k]] = Assigner(global[idx[k]], local[k]) for all k.
+  /** The local contribution \p local can be any vector expression, that 
+   *  is evaluated elementwise. The \p Mode selects, whether the update of
+   *  the global entries is safe for concurrent threads, see \ref scatter.
+   **/
+  template <Memory_policy Target, VectorExpr I, VectorExpr E, class Assigner, class Mode>
+    requires Integral<Value_type<I>>
+  inline void scatter_assign(Target& global, I const& idx, E const& local, Assigner assigner, Mode mode)
+  {
+    typedef Value_type<Target> T;
+    TEST_EXIT_DBG( size(idx) == size(local) )("Sizes do not match!\n");
+    
+    T* data = global.data();
+    for (size_t k = 0; k < size(idx); ++k) {
+      TEST_EXIT_DBG( size_t(idx(k)) < size_t(global.getSize()) )("Index out of range!\n");
+      aux::scatter_update(data[idx(k)], T(local(k)), assigner, mode);
+    }
+  }
+  
+  /// \brief scatter-add global[idx[k]] += local[k] for all k.
+  template <Memory_policy Target, VectorExpr I, VectorExpr E, class Mode = scatter::serial>
+    requires Integral<Value_type<I>>
+  inline void scatter_add(Target& global, I const& idx, E const& local, Mode mode = Mode())
+  {
+    scatter_assign(global, idx, local, assign::plus<Value_type<Target>>(), mode);
+  }
+  
+  
+  // ---------------------------------------------------------------------------
+  // assembly loops
+  
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    // call f(elements[i], mode) for i in [0, n), distributed on 
+    // \p num_threads blocks of consecutive elements, that are processed by 
+    // the threads of the thread pool.
+    template <class Elements, class Kernel, class Mode>
+    void parallel_for_elements(Elements const& elements, size_t n, Kernel& kernel, 
+			       Mode mode, size_t num_threads)
+    {
+      num_threads = std::min(num_threads, n);
+      if (num_threads <= 1) {
+	for (size_t i = 0; i < n; ++i)
+	  kernel(elements(i), mode);
+	return;
+      }
+      
+      ThreadPool::instance().parallel_for(num_threads, [&](size_t t) {
+	size_t const begin = (n * t) / num_threads;
+	size_t const end = (n * (t+1)) / num_threads;
+	for (size_t i = begin; i < end; ++i)
+	  kernel(elements(i), mode);
+      });
+    }
+    
+  } // end namespace aux
+  /// \endcond
+  
+  
+  /// \brief assembly loop over the elements [0, n), that calls 
+  /// kernel(element, mode) for each element. 
+  /** The kernel computes the element contribution and adds it to the global
+   *  container by \ref scatter_add(global, idx, local, mode). In the serial
+   *  mode all elements are processed in order by the calling thread, in the
+   *  atomic mode they are distributed to \p num_threads threads, i.e. the
+   *  kernel must be thread-safe.
+   **/
+  template <class Kernel, class Mode>
+    requires !std::is_same<Mode, scatter::coloured>::value
+  void assemble(size_t n, Kernel kernel, Mode mode, 
+		size_t num_threads = std::thread::hardware_concurrency())
+  {
+    auto elements = [](size_t i) { return i; };
+    aux::parallel_for_elements(elements, n, kernel, mode, 
+			       std::is_same<Mode, scatter::serial>::value ? 1 : num_threads);
+  }
+  
+  /// \brief assembly loop over the elements of a colouring. 
+  /** \p colours is a list of element lists, such that elements of the same 
+   *  colour do not share any global index. The colours are processed one 
+   *  after the other, the elements of one colour concurrently by 
+   *  \p num_threads threads, that scatter without atomic operations.
+   **/
+  template <class Colouring, class Kernel>
+  void assemble(Colouring const& colours, Kernel kernel, scatter::coloured mode,
+		size_t num_threads = std::thread::hardware_concurrency())
+  {
+    for (auto const& colour : colours) {
+      auto elements = [&colour](size_t i) { return colour[i]; };
+      aux::parallel_for_elements(elements, colour.size(), kernel, mode, num_threads);
+    }
+  }
+  
+} // end namespace AMDiS
@@ -0,0 +1,475 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file simd_math.hpp */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>	// std::memcpy
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>	// packed square-root
+#endif
+
+#include "operations/generic_loops.hpp"	// meta::UNROLL
+#include "operations/functors.hpp"	// FunctorBase
+#include "operations/packet.hpp"		// simd::Packet, simd::packet_functor
+#include "traits/eval_cost.hpp"		// traits::functor_flops
+
+namespace AMDiS 
+{
+  namespace simd
+  {
+    // Vectorized elementary functions for packets of float and double. All 
+    // lanes are evaluated by the same branch-free instruction sequence, with
+    // special values selected by masks. The scalar overloads use the same 
+    // algorithm, so that the scalar tail of a loop agrees with the packet 
+    // part (up to contraction of multiply-adds by the compiler).
+    
+    /// \cond HIDDEN_SYMBOLS
+    namespace aux
+    {
+      /// constants of the floating-point format and the polynomial 
+      /// approximations for the value type \p T
+      template <class T> struct math_constants;
+      
+      template <>
+      struct math_constants<double>
+      {
+	typedef std::int64_t int_type;
+	
+	static constexpr int     mantissa      = 52;
+	static constexpr int     bias          = 1023;
+	static constexpr int_type mantissa_mask = 0x000fffffffffffffLL;
+	static constexpr double  shifter       = 6755399441055744.0;	// 1.5 * 2^52
+	static constexpr double  magic         = 4503599627370496.0;	// 2^52
+	static constexpr double  scale_sub     = 18014398509481984.0;	// 2^54
+	static constexpr int     exp_sub       = 54;
+	
+	static constexpr double  ln2_hi = 6.93147180369123816490e-01;
+	static constexpr double  ln2_lo = 1.90821492927058770002e-10;
+	static constexpr double  log2e  = 1.44269504088896338700e+00;
+	static constexpr double  sqrt2  = 1.41421356237309504880e+00;
+	
+	// exp(x) overflows for x > exp_max and underflows for x < exp_min
+	static constexpr double  exp_max = 709.782712893383973096;
+	static constexpr double  exp_min = -745.133219101941108420;
+	
+	// Taylor polynomial of exp(r), |r| <= ln(2)/2, degree 13
+	static constexpr int     exp_degree = 13;
+	
+	// minimax coefficients of log(1+f), from fdlibm
+	static constexpr double  Lg1 = 6.666666666666735130e-01;
+	static constexpr double  Lg2 = 3.999999999940941908e-01;
+	static constexpr double  Lg3 = 2.857142874366239149e-01;
+	static constexpr double  Lg4 = 2.222219843214978396e-01;
+	static constexpr double  Lg5 = 1.818357216161805012e-01;
+	static constexpr double  Lg6 = 1.531383769920937332e-01;
+	static constexpr double  Lg7 = 1.479819860511658591e-01;
+      };
+      
+      template <>
+      struct math_constants<float>
+      {
+	typedef std::int32_t int_type;
+	
+	static constexpr int     mantissa      = 23;
+	static constexpr int     bias          = 127;
+	static constexpr int_type mantissa_mask = 0x007fffff;
+	static constexpr float   shifter       = 12582912.0f;		// 1.5 * 2^23
+	static constexpr float   magic         = 8388608.0f;		// 2^23
+	static constexpr float   scale_sub     = 33554432.0f;		// 2^25
+	static constexpr int     exp_sub       = 25;
+	
+	static constexpr float   ln2_hi = 6.9313812256e-01f;
+	static constexpr float   ln2_lo = 9.0580006145e-06f;
+	static constexpr float   log2e  = 1.4426950409e+00f;
+	static constexpr float   sqrt2  = 1.4142135624e+00f;
+	
+	static constexpr float   exp_max = 88.7228391117f;
+	static constexpr float   exp_min = -103.9720770840f;
+	
+	static constexpr int     exp_degree = 7;
+	
+	static constexpr float   Lg1 = 6.6666668653e-01f;
+	static constexpr float   Lg2 = 4.0000000596e-01f;
+	static constexpr float   Lg3 = 2.8571429849e-01f;
+	static constexpr float   Lg4 = 2.2222198546e-01f;
+	static constexpr float   Lg5 = 1.8183572590e-01f;
+	static constexpr float   Lg6 = 1.5313838422e-01f;
+	static constexpr float   Lg7 = 1.4798198640e-01f;
+      };
+      
+      
+      /// value type and integer type of the same width for scalars and packets
+      /// of float or double. Not defined for other types.
+      template <class P>
+      struct math_traits {};
+      
+      template <>
+      struct math_traits<double>
+      {
+	typedef double                                                       value_type;
+	typedef std::int64_t                                                   int_type;
+      };
+      
+      template <>
+      struct math_traits<float>
+      {
+	typedef float                                                        value_type;
+	typedef std::int32_t                                                   int_type;
+      };
+      
+#if defined(__GNUC__)
+      template <class T, int Bytes>
+      struct packet_math_traits
+      {
+	typedef T                                                            value_type;
+	typedef typename math_traits<T>::int_type int_type __attribute__((vector_size(Bytes)));
+      };
+      
+      // packets of SSE, AVX and AVX-512 width, see the kernels of cpu_dispatch.hpp
+      template <> struct math_traits<Packet<double, 16>> : packet_math_traits<double, 16> {};
+      template <> struct math_traits<Packet<double, 32>> : packet_math_traits<double, 32> {};
+      template <> struct math_traits<Packet<double, 64>> : packet_math_traits<double, 64> {};
+      template <> struct math_traits<Packet<float, 16>>  : packet_math_traits<float, 16> {};
+      template <> struct math_traits<Packet<float, 32>>  : packet_math_traits<float, 32> {};
+      template <> struct math_traits<Packet<float, 64>>  : packet_math_traits<float, 64> {};
+#endif
+      
+      /// reinterpret the bits of \p x as type \p To
+      template <class To, class From>
+      inline To bit_cast(From const& x)
+      {
+	static_assert(sizeof(To) == sizeof(From), "Sizes do not match!");
+	To y;
+	std::memcpy(&y, &x, sizeof(y));
+	return y;
+      }
+      
+      /// scalar or packet with all elements equal to \p value
+      template <class P, class T>
+      inline P splat(T value)
+      {
+	return P{} + value;
+      }
+      
+      /// 1/k!
+      constexpr long double inv_factorial(int k)
+      {
+	long double f = 1;
+	for (int i = 2; i <= k; ++i)
+	  f *= i;
+	return 1 / f;
+      }
+      
+      /// Taylor polynomial sum_{k=0}^N r^k/k! by the Horner scheme
+      template <int N, class P>
+      inline P exp_polynomial(P const& r)
+      {
+	typedef typename math_traits<P>::value_type T;
+	
+	P p = splat<P>(T(inv_factorial(N)));
+	meta::UNROLL<1, N+1>::apply([&](auto k) { p = p * r + T(inv_factorial(N - k)); });
+	return p;
+      }
+      
+    } // end namespace aux
+    /// \endcond
+    
+    
+    /// \brief exp(x) for scalars and packets of float or double.
+    /** Range reduction x = n*ln(2) + r, |r| <= ln(2)/2, with a Taylor 
+     *  polynomial of degree 13 (double) or 7 (float) for exp(r). The result 
+     *  is scaled by 2^n without branches. Maximal error: 1 ulp in the normal 
+     *  range. Overflows to inf for x > 709.78 (88.72) and underflows to 0 for 
+     *  x < -745.13 (-103.97), with gradual underflow in between.
+     **/
+    template <class P>
+      requires requires() { typename aux::math_traits<P>::int_type; }
+    inline P exp(P x)
+    {
+      typedef typename aux::math_traits<P>::value_type T;
+      typedef typename aux::math_traits<P>::int_type   I;
+      typedef aux::math_constants<T>                   C;
+      using aux::splat;
+      using aux::bit_cast;
+      
+      P const hi = splat<P>(C::exp_max), lo = splat<P>(C::exp_min);
+      P const xc = x > hi ? hi : (x < lo ? lo : x);
+      
+      // n = round(x / ln(2)), using the rounding of the addition of 1.5*2^52
+      P const k = xc * C::log2e + C::shifter;
+      P const n = k - C::shifter;
+      P const r = (xc - n * C::ln2_hi) - n * C::ln2_lo;
+      
+      P const p = aux::exp_polynomial<C::exp_degree>(r);
+      
+      // 2^n = 2^h * 2^(n-h), so that both factors are normal numbers
+      I const ni = bit_cast<I>(k) - bit_cast<I>(splat<P>(C::shifter));
+      I const h = ni >> 1;
+      P const s1 = bit_cast<P>((h + C::bias) << C::mantissa);
+      P const s2 = bit_cast<P>((ni - h + C::bias) << C::mantissa);
+      
+      P result = p * s1 * s2;
+      result = x > hi ? splat<P>(std::numeric_limits<T>::infinity()) : result;
+      result = x < lo ? splat<P>(T(0)) : result;
+      return x != x ? x : result;
+    }
+    
+    
+    /// \brief log(x) for scalars and packets of float or double.
+    /** Reduction x = 2^e * m, sqrt(2)/2 <= m < sqrt(2), with the minimax 
+     *  approximation of log(m) of fdlibm. Maximal error: 1 ulp, including 
+     *  subnormal arguments. log(0) = -inf, log(x<0) = NaN, log(inf) = inf.
+     **/
+    template <class P>
+      requires requires() { typename aux::math_traits<P>::int_type; }
+    inline P log(P x)
+    {
+      typedef typename aux::math_traits<P>::value_type T;
+      typedef typename aux::math_traits<P>::int_type   I;
+      typedef aux::math_constants<T>                   C;
+      using aux::splat;
+      using aux::bit_cast;
+      
+      P const zero = splat<P>(T(0)), one = splat<P>(T(1));
+      
+      // subnormal numbers are scaled to the normal range
+      auto const subnormal = x < std::numeric_limits<T>::min();
+      P const xs = subnormal ? x * C::scale_sub : x;
+      
+      // exponent as floating-point number, using the bits of 2^52 + e
+      I const bits = bit_cast<I>(xs);
+      I const magic_bits = bit_cast<I>(splat<P>(C::magic));
+      P e = bit_cast<P>((bits >> C::mantissa) | magic_bits) - (C::magic + C::bias);
+      e = subnormal ? e - T(C::exp_sub) : e;
+      
+      // mantissa in [1, 2), shifted to [sqrt(2)/2, sqrt(2))
+      P m = bit_cast<P>((bits & C::mantissa_mask) | bit_cast<I>(one));
+      auto const large = m > C::sqrt2;
+      m = large ? m * T(0.5) : m;
+      e = large ? e + T(1) : e;
+      
+      // log(1+f) = f - f^2/2 + s*(f^2/2 + R(s^2)), with s = f/(2+f)
+      P const f = m - T(1);
+      P const s = f / (T(2) + f);
+      P const z = s * s;
+      P const w = z * z;
+      P const t1 = w * (C::Lg2 + w * (C::Lg4 + w * C::Lg6));
+      P const t2 = z * (C::Lg1 + w * (C::Lg3 + w * (C::Lg5 + w * C::Lg7)));
+      P const R = t2 + t1;
+      P const hfsq = T(0.5) * f * f;
+      
+      P result = e * C::ln2_hi - ((hfsq - (s * (hfsq + R) + e * C::ln2_lo)) - f);
+      result = x < zero ? splat<P>(std::numeric_limits<T>::quiet_NaN()) : result;
+      result = x == zero ? splat<P>(-std::numeric_limits<T>::infinity()) : result;
+      result = x == std::numeric_limits<T>::infinity() ? x : result;
+      return x != x ? x : result;
+    }
+    
+    
+    /// \brief pow(x, y) = exp(y * log(x)) for x >= 0, for scalars and packets 
+    /// of float or double.
+    /** The rounding error of log(x) is amplified by |y*log(x)|, so the 
+     *  maximal error is about 1 + 1.5*|y*log(x)| ulp, i.e. 1 ulp for moderate
+     *  arguments, but ~10 ulp for pow(10, 2.5) and ~1000 ulp close to 
+     *  overflow. Use std::pow if full accuracy is required for large results.
+     *  As for std::pow, pow(x, 0) = 1 and pow(1, y) = 1 for all x and y, also 
+     *  inf and NaN, and pow(0, y) is 0 for y > 0, inf for y < 0 and NaN for 
+     *  y = NaN. In contrast to std::pow, negative arguments x < 0 result in 
+     *  NaN, also for integer exponents, and pow(-0, y) = pow(0, y).
+     **/
+    template <class P>
+      requires requires() { typename aux::math_traits<P>::int_type; }
+    inline P pow(P x, P y)
+    {
+      typedef typename aux::math_traits<P>::value_type T;
+      using aux::splat;
+      
+      P const zero = splat<P>(T(0)), one = splat<P>(T(1));
+      P result = simd::exp(y * simd::log(x));
+      
+      P const pow0 = y > zero ? zero : (y < zero ? splat<P>(std::numeric_limits<T>::infinity()) : y);
+      result = x == zero ? pow0 : result;
+      result = x == one ? one : result;
+      return y == zero ? one : result;
+    }
+    
+    
+    /// \cond HIDDEN_SYMBOLS
+    // packed square-root instructions, that do not set errno
+#if defined(__AVX512F__) && SIMD_BYTES == 64
+    inline Packet<double> sqrt(Packet<double> x) { return _mm512_sqrt_pd(x); }
+    inline Packet<float>  sqrt(Packet<float> x)  { return _mm512_sqrt_ps(x); }
+#elif defined(__AVX__) && SIMD_BYTES == 32
+    inline Packet<double> sqrt(Packet<double> x) { return _mm256_sqrt_pd(x); }
+    inline Packet<float>  sqrt(Packet<float> x)  { return _mm256_sqrt_ps(x); }
+#elif defined(__SSE2__) && SIMD_BYTES == 16
+    inline Packet<double> sqrt(Packet<double> x) { return _mm_sqrt_pd(x); }
+    inline Packet<float>  sqrt(Packet<float> x)  { return _mm_sqrt_ps(x); }
+#endif
+    /// \endcond
+    
+    /// \brief sqrt(x) for packets.
+    /** The square-root is a correctly rounded (0.5 ulp) hardware instruction,
+     *  the packed instruction of SSE2, AVX or AVX-512 for the packet width 
+     *  SIMD_BYTES. Wider packets are split into packets of that width. 
+     *  Otherwise it is applied lane by lane.
+     **/
+    template <class P>
+      requires requires() { typename aux::math_traits<P>::int_type; }
+    inline P sqrt(P x)
+    {
+      typedef typename aux::math_traits<P>::value_type T;
+      P result;
+      if (sizeof(P) > SIMD_BYTES) {
+	constexpr int N = (sizeof(P) > SIMD_BYTES ? sizeof(P) / SIMD_BYTES : 1);
+	Packet<T> parts[N];
+	std::memcpy(parts, &x, sizeof(x));
+	meta::UNROLL<0, N>::apply([&](auto k) { parts[k] = simd::sqrt(parts[k]); });
+	std::memcpy(&result, parts, sizeof(result));
+      } else {
+	meta::UNROLL<0, sizeof(P) / sizeof(T)>::apply([&](auto k) { result[int(k)] = std::sqrt(x[int(k)]); });
+      }
+      return result;
+    }
+    
+    /// sqrt(x) for scalars
+    inline double sqrt(double x) { return std::sqrt(x); }
+    
+    /// sqrt(x) for scalars
+    inline float sqrt(float x) { return std::sqrt(x); }
+    
+    
+    /// exp(x) of the standard library for all other value types, e.g. complex
+    template <class T>
+    inline T exp(T x) { return std::exp(x); }
+    
+    /// log(x) of the standard library for all other value types, e.g. complex
+    template <class T>
+    inline T log(T x) { return std::log(x); }
+    
+    /// pow(x, y) of the standard library for all other value types, e.g. complex
+    template <class T>
+    inline T pow(T x, T y) { return std::pow(x, y); }
+    
+    /// sqrt(x) of the standard library for all other value types, e.g. complex
+    template <class T>
+    inline T sqrt(T x) { return std::sqrt(x); }
+    
+  } // end namespace simd
+  
+  
+  namespace functors 
+  {
+    /// exp(v), vectorized for float and double
+    template <class T>
+    struct exp : FunctorBase
+    {
+      typedef T result_type;
+      typedef T  value_type;
+      
+      static result_type apply(const T& v) { return simd::exp(v); }
+      result_type operator()(const T& v) const { return apply(v); }
+    };
+    
+    /// log(v), vectorized for float and double
+    template <class T>
+    struct log : FunctorBase
+    {
+      typedef T result_type;
+      typedef T  value_type;
+      
+      static result_type apply(const T& v) { return simd::log(v); }
+      result_type operator()(const T& v) const { return apply(v); }
+    };
+    
+    /// v^p with runtime exponent p, vectorized for float and double
+    template <class T1, class T2>
+    struct power : FunctorBase
+    {
+      typedef T1 result_type;
+      typedef T1  value_type;
+      
+      static result_type apply(const T1& v, const T2& p) { return simd::pow(v, T1(p)); }
+      result_type operator()(const T1& v, const T2& p) const { return apply(v, p); }
+    };
+    
+  } // end namespace functors
+  
+  
+  namespace simd
+  {
+    /// \cond HIDDEN_SYMBOLS
+    template <class T>
+    struct packet_functor<functors::exp<T>> : true_
+    {
+      template <class P>
+      static P apply(P const& a) { return simd::exp(a); }
+    };
+    
+    template <class T>
+    struct packet_functor<functors::log<T>> : true_
+    {
+      template <class P>
+      static P apply(P const& a) { return simd::log(a); }
+    };
+    
+    template <class T>
+    struct packet_functor<functors::sqrt<T>> : true_
+    {
+      template <class P>
+      static P apply(P const& a) { return simd::sqrt(a); }
+    };
+    
+    template <class T1, class T2>
+    struct packet_functor<functors::power<T1, T2>> : true_
+    {
+      template <class P>
+      static P apply(P const& a, P const& b) { return simd::pow(a, b); }
+    };
+    /// \endcond
+    
+  } // end namespace simd
+  
+  
+  namespace traits
+  {
+    /// \cond HIDDEN_SYMBOLS
+    // range reduction, polynomial of degree 13 and scaling, see simd::exp
+    template <class T>
+    struct functor_flops<functors::exp<T>> : int_<36> {};
+    
+    // range reduction and polynomial of degree 14 in s, see simd::log
+    template <class T>
+    struct functor_flops<functors::log<T>> : int_<32> {};
+    
+    template <class T1, class T2>
+    struct functor_flops<functors::power<T1, T2>> : int_<69> {};
+    /// \endcond
+    
+  } // end namespace traits
+} // end namespace AMDiS
@@ -0,0 +1,193 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file aliasing.hpp */
+
+#pragma once
+
+#include <functional>	// std::less
+
+#include "traits/concepts.hpp"
+#include "operations/meta.hpp"
+#include "expressions/all_expr_fwd.hpp"
+
+namespace AMDiS 
+{
+  namespace traits
+  {
+    /// \brief evaluates to true, if the evaluation of expr(i) reads only 
+    /// the i-th element of all containers in the expression \p E.
+    /** Those expressions can be assigned to a container that is part of the 
+     *  expression, e.g. v = v + w. Expressions that read other elements, 
+     *  like A*v or cross(v,w), must be evaluated through a temporary if the
+     *  target aliases an argument.
+     **/
+    template <class E>
+    struct alias_safe : true_ {};
+    
+    /// \cond HIDDEN_SYMBOLS
+    template <class E, class F>
+    struct alias_safe<ElementwiseUnaryExpr<E, F>> : alias_safe<E> {};
+    
+    template <class E1, class E2, class F>
+    struct alias_safe<ElementwiseBinaryExpr<E1, E2, F>> 
+      : bool_< alias_safe<E1>::value && alias_safe<E2>::value > {};
+    
+    template <class V, class E, bool l, class F>
+    struct alias_safe<ScaleExpr<V, E, l, F>> : alias_safe<E> {};
+    
+    template <class V1, class E1, class V2, class E2>
+    struct alias_safe<AxpbyExpr<V1, E1, V2, E2>> 
+      : bool_< alias_safe<E1>::value && alias_safe<E2>::value > {};
+      
+    template <class E1, class E2, class F>
+    struct alias_safe<VectorBinaryExpr<E1, E2, F>> : false_ {};
+    
+    // reads the elements idx(i) of the global expression
+    template <class G, class I>
+    struct alias_safe<IndexedExpr<G, I>> : false_ {};
+    
+    template <class A, class B, class F>
+    struct alias_safe<CompareExpr<A, B, F>> 
+      : bool_< alias_safe<A>::value && alias_safe<B>::value > {};
+    
+    template <class M, class A, class B>
+    struct alias_safe<WhereExpr<M, A, B>> 
+      : bool_< alias_safe<M>::value && alias_safe<A>::value && alias_safe<B>::value > {};
+    
+    template <class E, class F>
+    struct alias_safe<ReductionUnaryExpr<E, F>> : false_ {};
+    
+    template <class E1, class E2, class F>
+    struct alias_safe<ReductionBinaryExpr<E1, E2, F>> : false_ {};
+    
+    // a buffered vector argument is evaluated when the expression is created
+    template <class M, class V, bool use_buffer>
+    struct alias_safe<MatVecExpr<M, V, use_buffer>> : bool_< use_buffer > {};
+    
+    template <class M1, class M2>
+    struct alias_safe<MatMatExpr<M1, M2>> : false_ {};
+    
+    template <class V, class W>
+    struct alias_safe<OuterExpr<V, W>> : false_ {};
+    /// \endcond
+    
+  } // end namespace traits
+  
+  
+  // ---------------------------------------------------------------------------
+  // runtime test, whether an expression reads from the memory block [lo, hi)
+  
+  /// scalars and unknown leaves do not alias any memory
+  template <class E>
+  inline bool aliases(E const&, void const*, void const*) { return false; }
+  
+  /// containers alias, if the memory blocks overlap
+  template <Memory_policy C>
+  inline bool aliases(C const& c, void const* lo, void const* hi)
+  {
+    std::less<void const*> less;
+    void const* c_lo = c.data();
+    void const* c_hi = c.data() + c.getSize();
+    return less(c_lo, hi) && less(lo, c_hi);
+  }
+  
+  template <class E, class F>
+  inline bool aliases(ElementwiseUnaryExpr<E, F> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi);
+  }
+  
+  template <class E1, class E2, class F>
+  inline bool aliases(ElementwiseBinaryExpr<E1, E2, F> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi) || aliases(expr.get_second(), lo, hi);
+  }
+  
+  template <class V, class E, bool l, class F>
+  inline bool aliases(ScaleExpr<V, E, l, F> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi);
+  }
+  
+  template <class V1, class E1, class V2, class E2>
+  inline bool aliases(AxpbyExpr<V1, E1, V2, E2> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi) || aliases(expr.get_second(), lo, hi);
+  }
+  
+  template <class E1, class E2, class F>
+  inline bool aliases(VectorBinaryExpr<E1, E2, F> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi) || aliases(expr.get_second(), lo, hi);
+  }
+  
+  template <class G, class I>
+  inline bool aliases(IndexedExpr<G, I> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_global(), lo, hi) || aliases(expr.get_index(), lo, hi);
+  }
+  
+  template <class A, class B, class F>
+  inline bool aliases(CompareExpr<A, B, F> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi) || aliases(expr.get_second(), lo, hi);
+  }
+  
+  template <class M, class A, class B>
+  inline bool aliases(WhereExpr<M, A, B> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_mask(), lo, hi) || aliases(expr.get_first(), lo, hi) 
+	|| aliases(expr.get_second(), lo, hi);
+  }
+  
+  template <class E, class F>
+  inline bool aliases(ReductionUnaryExpr<E, F> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi);
+  }
+  
+  template <class E1, class E2, class F>
+  inline bool aliases(ReductionBinaryExpr<E1, E2, F> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi) || aliases(expr.get_second(), lo, hi);
+  }
+  
+  template <class M, class V, bool b>
+  inline bool aliases(MatVecExpr<M, V, b> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_matrix(), lo, hi) || aliases(expr.get_vector(), lo, hi);
+  }
+  
+  template <class M1, class M2>
+  inline bool aliases(MatMatExpr<M1, M2> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi) || aliases(expr.get_second(), lo, hi);
+  }
+  
+  template <class V, class W>
+  inline bool aliases(OuterExpr<V, W> const& expr, void const* lo, void const* hi)
+  {
+    return aliases(expr.get_first(), lo, hi) || aliases(expr.get_second(), lo, hi);
+  }
+  
+} // end namespace AMDiS
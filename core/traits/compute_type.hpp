@@ -0,0 +1,47 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file compute_type.hpp */
+
+#pragma once
+
+namespace AMDiS 
+{
+  namespace traits
+  {
+    /// \brief type used for arithmetics on values of type \p T.
+    /** Storage types, like the 16-bit floating-point types, are converted to
+     *  the compute type on load, so that intermediate values in expressions
+     *  and accumulators of reductions are not rounded to the storage precision.
+     **/
+    template <class T>
+    struct compute_type_aux
+    {
+      typedef T type;
+    };
+    
+    template <class T>
+    using compute_type = typename compute_type_aux<T>::type;
+    
+  } // end namespace traits
+
+} // end namespace AMDiS
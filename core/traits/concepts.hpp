@@ -40,6 +40,22 @@ namespace AMDiS
   template <class T>
     requires requires() { typename T::result_type; }
   using Result_type = typename T::result_type;
+  
+  namespace traits
+  {
+    /// type of the partial results of a reduction functor \p F, i.e. 
+    /// F::accumulator_type if defined, otherwise F::result_type
+    template <class F>
+    struct accumulator_type { typedef Result_type<F> type; };
+    
+    template <class F>
+      requires requires() { typename F::accumulator_type; }
+    struct accumulator_type<F> { typedef typename F::accumulator_type type; };
+    
+  } // end namespace traits
+  
+  template <class T>
+  using Accumulator_type = typename traits::accumulator_type<T>::type;
     
   
   /// \brief concepts to test for expressions
@@ -60,6 +76,14 @@ namespace AMDiS
     };
   
     
+  /// \brief optional SIMD access: expr.packet(i) returns the elements 
+  /// [i, i+W) as packet, see operations/packet.hpp
+  template <class T> concept bool Packet_expression = Expression<T> && 
+    requires(T expr, Size_type<T> i) { 
+      expr.packet(i); 
+    };
+  
+    
   /// \brief Concepts to test for matrices
   template <class T>
   concept bool MatrixExpr = Expression<T> &&
@@ -136,7 +160,7 @@ namespace AMDiS
   template <class F, class... Ts>
   concept bool Reduction_sfunctor = 
       requires() { typename Result_type<F>; } &&	// type requirement
-      requires(Result_type<F> erg, Ts... args) { 
+      requires(Accumulator_type<F> erg, Ts... args) { 
 	F::init(erg);					// init the value erg
 	F::update(erg, args...); 			// update the value erg
 	{ F::post_reduction(erg) } -> Result_type<F>; 	// apply a post reduction
@@ -0,0 +1,264 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file eval_cost.hpp */
+
+#pragma once
+
+#include <type_traits>
+
+#include "traits/concepts.hpp"
+#include "operations/meta.hpp"
+#include "expressions/all_expr_fwd.hpp"
+
+namespace AMDiS 
+{
+  namespace traits
+  {
+    /// size assumed for dimensions that are not known at compile-time
+    static constexpr int COST_DYNAMIC_SIZE = 64;
+    
+    /// \brief number of floating-point operations of a static functor \p F.
+    /** Arithmetic operators and comparisons count as one operation. More 
+     *  expensive functors, e.g. the elementary functions in 
+     *  operations/simd_math.hpp, specialize this trait.
+     **/
+    template <class F>
+    struct functor_flops : int_<1> {};
+    
+    
+    /// \brief compile-time cost model of the evaluation of an expression \p E.
+    /** All values are given per element expr(i) of the expression:
+     *  - flops: number of floating-point operations,
+     *  - loads: number of elements read from containers,
+     *  - stores: number of elements written to temporary buffers,
+     *  - temporaries: number of temporary buffers created by the evaluation 
+     *    (not per element).
+     *  Work, that is done once for the whole expression, e.g. the evaluation 
+     *  of the buffered vector of a matrix-vector product, is distributed over
+     *  its elements. Unknown sizes are replaced by COST_DYNAMIC_SIZE. 
+     *  Containers load one element, scalars are free. The type \p E must 
+     *  not be cv- or reference-qualified.
+     **/
+    template <class E>
+    struct expr_cost
+    {
+      static constexpr double flops = 0;
+      static constexpr double loads = 0;
+      static constexpr double stores = 0;
+      static constexpr int temporaries = 0;
+    };
+    
+    
+    /// \brief compile-time estimate of the number of floating-point operations 
+    /// needed to evaluate one element expr(i) of an expression \p E.
+    /** Containers and scalars have cost 0. The estimate is used to decide 
+     *  whether a sub-expression, that is accessed multiple times, should be 
+     *  evaluated into a buffer first.
+     **/
+    template <class E>
+    struct eval_cost 
+      : int_< int(expr_cost<std::remove_cv_t<std::remove_reference_t<E>>>::flops + 0.5) > {};
+    
+    
+    /// \cond HIDDEN_SYMBOLS
+    namespace aux
+    {
+      constexpr double sum() { return 0; }
+      
+      template <class... Ts>
+      constexpr double sum(double x, Ts... xs) { return x + sum(xs...); }
+      
+      constexpr int isum() { return 0; }
+      
+      template <class... Ts>
+      constexpr int isum(int x, Ts... xs) { return x + isum(xs...); }
+      
+      // static size or COST_DYNAMIC_SIZE
+      constexpr int cost_size(int n) { return n > 0 ? n : COST_DYNAMIC_SIZE; }
+      
+      // combination of the elements i of all arguments \p Es with F flops
+      template <int F, class... Es>
+      struct elementwise_cost
+      {
+	static constexpr double flops = F + sum(expr_cost<Es>::flops...);
+	static constexpr double loads = sum(expr_cost<Es>::loads...);
+	static constexpr double stores = sum(expr_cost<Es>::stores...);
+	static constexpr int temporaries = isum(expr_cost<Es>::temporaries...);
+      };
+      
+      // reduction of N elements of a cost model C
+      template <int N, class C>
+      struct reduction_cost
+      {
+	static constexpr double flops = N * C::flops;
+	static constexpr double loads = N * C::loads;
+	static constexpr double stores = N * C::stores;
+	static constexpr int temporaries = C::temporaries;
+      };
+      
+      // argument E, that is read N times per element, evaluated once into a
+      // buffer, if it is not a container or scalar, see VectorBinaryExpr
+      template <int N, class E, bool buffered = (eval_cost<E>::value > 0)>
+      struct buffered_cost : reduction_cost<N, expr_cost<E>> {};
+      
+      template <int N, class E>
+      struct buffered_cost<N, E, true>
+      {
+	static constexpr double flops = expr_cost<E>::flops;
+	static constexpr double loads = expr_cost<E>::loads + N;
+	static constexpr double stores = expr_cost<E>::stores + 1;
+	static constexpr int temporaries = expr_cost<E>::temporaries + 1;
+      };
+      
+    } // end namespace aux
+    
+    template <Memory_policy E>
+    struct expr_cost<E>
+    {
+      static constexpr double flops = 0;
+      static constexpr double loads = 1;
+      static constexpr double stores = 0;
+      static constexpr int temporaries = 0;
+    };
+    
+    template <class E, class F>
+    struct expr_cost<ElementwiseUnaryExpr<E, F>> 
+      : aux::elementwise_cost< functor_flops<F>::value, E > {};
+    
+    template <class E1, class E2, class F>
+    struct expr_cost<ElementwiseBinaryExpr<E1, E2, F>> 
+      : aux::elementwise_cost< functor_flops<F>::value, E1, E2 > {};
+    
+    template <class V, class E, bool l, class F>
+    struct expr_cost<ScaleExpr<V, E, l, F>> 
+      : aux::elementwise_cost< functor_flops<F>::value, E > {};
+    
+    // one multiply-add per element, plus the scaling of the second argument
+    template <class V1, class E1, class V2, class E2>
+    struct expr_cost<AxpbyExpr<V1, E1, V2, E2>> 
+      : aux::elementwise_cost< 3, E1, E2 > {};
+      
+    template <class V1, class E1, class E2>
+    struct expr_cost<AxpbyExpr<V1, E1, AMDiS::aux::unit_scale, E2>> 
+      : aux::elementwise_cost< 2, E1, E2 > {};
+      
+    // each element of the cross-product reads two elements of each argument
+    template <class E1, class E2, class F>
+    struct expr_cost<VectorBinaryExpr<E1, E2, F>> 
+    {
+      typedef aux::buffered_cost<2, E1> cost1;
+      typedef aux::buffered_cost<2, E2> cost2;
+      
+      static constexpr double flops = cost1::flops + cost2::flops + 3;
+      static constexpr double loads = cost1::loads + cost2::loads;
+      static constexpr double stores = cost1::stores + cost2::stores;
+      static constexpr int temporaries = cost1::temporaries + cost2::temporaries;
+    };
+    
+    // the indirect access is a load, the global expression is evaluated at idx(i)
+    template <class G, class I>
+    struct expr_cost<IndexedExpr<G, I>> 
+      : aux::elementwise_cost< 0, G, I > {};
+    
+    template <class A, class B, class F>
+    struct expr_cost<CompareExpr<A, B, F>> 
+      : aux::elementwise_cost< functor_flops<F>::value, A, B > {};
+    
+    // both operands are evaluated for all elements, then blended
+    template <class M, class A, class B>
+    struct expr_cost<WhereExpr<M, A, B>> 
+      : aux::elementwise_cost< 0, M, A, B > {};
+    
+    // one update per element
+    template <class E, class F>
+    struct expr_cost<ReductionUnaryExpr<E, F>> 
+      : aux::reduction_cost< aux::cost_size(E::_SIZE), aux::elementwise_cost<1, E> > {};
+    
+    // a multiplication and an addition per element
+    template <class E1, class E2, class F>
+    struct expr_cost<ReductionBinaryExpr<E1, E2, F>> 
+      : aux::reduction_cost< aux::cost_size(max(E1::_SIZE, E2::_SIZE)), 
+			     aux::elementwise_cost<2, E1, E2> > {};
+    
+    // an inner product of length num_cols(M) per element. A buffered vector 
+    // is evaluated once, i.e. 1/num_rows(M) times per element.
+    template <class M, class V, bool b>
+    struct expr_cost<MatVecExpr<M, V, b>> 
+    {
+      static constexpr int K = aux::cost_size(max(M::_COLS, V::_ROWS));
+      static constexpr double R = aux::cost_size(M::_ROWS);
+      
+      static constexpr double flops = K * (expr_cost<M>::flops + 2) 
+	+ (b ? K / R : K) * expr_cost<V>::flops;
+      static constexpr double loads = K * (expr_cost<M>::loads + (b ? 1 : 0)) 
+	+ (b ? K / R : K) * expr_cost<V>::loads;
+      static constexpr double stores = (b ? K / R : 0) + (b ? K / R : K) * expr_cost<V>::stores;
+      static constexpr int temporaries = (b ? 1 : 0) + expr_cost<M>::temporaries 
+	+ expr_cost<V>::temporaries;
+    };
+    
+    template <class M1, class M2>
+    struct expr_cost<MatMatExpr<M1, M2>> 
+      : aux::reduction_cost< aux::cost_size(max(M1::_COLS, M2::_ROWS)), 
+			     aux::elementwise_cost<2, M1, M2> > {};
+    
+    // assignment buffers both vectors and applies a rank-1 update
+    template <class V, class W>
+    struct expr_cost<OuterExpr<V, W>> 
+    {
+      static constexpr double R = aux::cost_size(V::_SIZE);
+      static constexpr double C = aux::cost_size(W::_SIZE);
+      
+      static constexpr double flops = 1 + expr_cost<V>::flops / C + expr_cost<W>::flops / R;
+      static constexpr double loads = 1 + expr_cost<V>::loads / C + expr_cost<W>::loads / R;
+      static constexpr double stores = 1 / C + 1 / R;
+      static constexpr int temporaries = 2 + expr_cost<V>::temporaries + expr_cost<W>::temporaries;
+    };
+    /// \endcond
+    
+    
+    /// \brief expected work of the assignment target = expr (\p compound = 
+    /// false) or target += expr (\p compound = true), for the runtime size
+    /// of \p expr.
+    /** Returns the total number of floating-point operations and the number 
+     *  of bytes moved between memory and registers, to compare the measured 
+     *  GFLOP/s and GB/s with the model.
+     **/
+    struct work_estimate
+    {
+      double flops;
+      double bytes;
+    };
+    
+    template <Expression E>
+    inline work_estimate expected_work(E const& expr, bool compound = false)
+    {
+      typedef expr_cost<E> C;
+      double const n = double(AMDiS::size(expr));
+      double const bytes = sizeof(Value_type<E>) * (C::loads + C::stores + (compound ? 2 : 1));
+      return work_estimate{ n * (C::flops + (compound ? 1 : 0)), n * bytes };
+    }
+    
+  } // end namespace traits
+
+} // end namespace AMDiS
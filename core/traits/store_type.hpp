@@ -0,0 +1,58 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file store_type.hpp */
+
+#pragma once
+
+#include "traits/concepts.hpp"
+
+namespace AMDiS 
+{
+  namespace traits
+  {
+    /// \brief type used to store a sub-expression of type \p E in an expression.
+    /** Expressions are lightweight and often temporaries, e.g. (a+b) in 
+     *  (a+b)*2.0, thus they are stored by value. Containers (types that
+     *  provide contiguous memory via data()) are stored by reference, to 
+     *  avoid copying the data.
+     **/
+    template <class E>
+    struct store_type_aux
+    {
+      typedef E type;
+    };
+    
+    /// \cond HIDDEN_SYMBOLS
+    template <Memory_policy E>
+    struct store_type_aux<E>
+    {
+      typedef E const& type;
+    };
+    /// \endcond
+    
+    template <class E>
+    using store_type = typename store_type_aux<E>::type;
+    
+  } // end namespace traits
+
+} // end namespace AMDiS
@@ -37,6 +37,9 @@ namespace AMDiS {
     
     struct expression {};
     
+    /// selects the compensated summation in reductions, e.g. sum(v, tag::compensated())
+    struct compensated {};
+    
   } // end namespace tag
     
 } // end namespace AMDiS
@@ -0,0 +1,395 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file half_float.hpp */
+
+#pragma once
+
+#include <cstdint>		// uint16_t, uint32_t
+#include <cstring>		// std::memcpy
+#include <cstddef>		// size_t
+#include <limits>		// std::numeric_limits
+#include <algorithm>		// std::min
+#include <type_traits>		// std::is_same
+
+#if defined(__F16C__) || defined(__AVX2__) || defined(__AVX512F__)
+  #include <immintrin.h>
+#endif
+
+#include "Config.h"			// ALIGNED
+#include "traits/compute_type.hpp"
+#include "operations/packet.hpp"		// simd::Packet, simd::load
+
+namespace AMDiS 
+{
+  /// \cond HIDDEN_SYMBOLS
+  namespace aux
+  {
+    inline uint32_t float_bits(float f)
+    {
+      uint32_t u; std::memcpy(&u, &f, sizeof(u));
+      return u;
+    }
+    
+    inline float bits_float(uint32_t u)
+    {
+      float f; std::memcpy(&f, &u, sizeof(f));
+      return f;
+    }
+    
+    /// IEEE binary32 -> binary16, round to nearest even
+    inline uint16_t float_to_half_bits(float value)
+    {
+      const uint32_t f32infty = 255u << 23;
+      const uint32_t f16max = (127u + 16u) << 23;
+      const uint32_t denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+      
+      uint32_t f = float_bits(value);
+      uint32_t sign = f & 0x80000000u;
+      f ^= sign;
+      
+      uint16_t h;
+      if (f >= f16max) {			// overflow -> inf, NaN -> qNaN
+	h = (f > f32infty) ? 0x7e00 : 0x7c00;
+      } else if (f < (113u << 23)) {		// subnormal result or zero
+	float tmp = bits_float(f) + bits_float(denorm_magic);
+	h = uint16_t(float_bits(tmp) - denorm_magic);
+      } else {					// normal result
+	uint32_t mant_odd = (f >> 13) & 1u;
+	f += (uint32_t(15 - 127) << 23) + 0xfffu;
+	f += mant_odd;
+	h = uint16_t(f >> 13);
+      }
+      return uint16_t(h | (sign >> 16));
+    }
+    
+    /// IEEE binary16 -> binary32 (exact)
+    inline float half_bits_to_float(uint16_t h)
+    {
+      const uint32_t shifted_exp = 0x7c00u << 13;
+      
+      uint32_t o = uint32_t(h & 0x7fffu) << 13;
+      uint32_t exp = shifted_exp & o;
+      o += (127u - 15u) << 23;
+      
+      if (exp == shifted_exp) {			// inf / NaN
+	o += (128u - 16u) << 23;
+      } else if (exp == 0) {			// zero / subnormal
+	o += 1u << 23;
+	o = float_bits(bits_float(o) - bits_float(113u << 23));
+      }
+      return bits_float(o | (uint32_t(h & 0x8000u) << 16));
+    }
+    
+    /// IEEE binary32 -> bfloat16, round to nearest even
+    inline uint16_t float_to_bfloat16_bits(float value)
+    {
+      uint32_t f = float_bits(value);
+      if ((f & 0x7fffffffu) > 0x7f800000u)	// keep NaN quiet
+	return uint16_t((f >> 16) | 0x40u);
+      f += 0x7fffu + ((f >> 16) & 1u);
+      return uint16_t(f >> 16);
+    }
+    
+    /// bfloat16 -> IEEE binary32 (exact)
+    inline float bfloat16_bits_to_float(uint16_t b)
+    {
+      return bits_float(uint32_t(b) << 16);
+    }
+    
+  } // end namespace aux
+  /// \endcond
+  
+  
+  /// 16-bit IEEE floating-point storage type (binary16)
+  /** Values are converted to float on load and rounded to nearest even 
+   *  on store. Use it as value_type of a container to halve the memory 
+   *  footprint. All arithmetics is performed in \ref traits::compute_type,
+   *  i.e. in float.
+   **/
+  struct half
+  {
+    uint16_t bits;
+    
+    /// default constructor, does not initialize the value
+    half() = default;
+    
+    /// rounding conversion from float, and from all other arithmetic types
+    /// via float, e.g. double, long or unsigned
+    template <class S>
+      requires std::is_arithmetic<S>::value
+    half(S value) : bits(aux::float_to_half_bits(float(value))) {}
+    
+    /// construct from raw bit pattern \p b
+    static half from_bits(uint16_t b) { half h; h.bits = b; return h; }
+    
+    /// conversion to float on load
+    operator float() const { return aux::half_bits_to_float(bits); }
+    
+    template <class S> half& operator+=(S const& s) { return *this = float(*this) + s; }
+    template <class S> half& operator-=(S const& s) { return *this = float(*this) - s; }
+    template <class S> half& operator*=(S const& s) { return *this = float(*this) * s; }
+    template <class S> half& operator/=(S const& s) { return *this = float(*this) / s; }
+  };
+  
+  
+  /// 16-bit brain floating-point storage type (8 bit exponent, 7 bit mantissa)
+  /** Same range as float with reduced precision. Conversion to float is
+   *  exact, conversion from float rounds to nearest even.
+   **/
+  struct bfloat16
+  {
+    uint16_t bits;
+    
+    /// default constructor, does not initialize the value
+    bfloat16() = default;
+    
+    /// rounding conversion from float, and from all other arithmetic types
+    /// via float, e.g. double, long or unsigned
+    template <class S>
+      requires std::is_arithmetic<S>::value
+    bfloat16(S value) : bits(aux::float_to_bfloat16_bits(float(value))) {}
+    
+    /// construct from raw bit pattern \p b
+    static bfloat16 from_bits(uint16_t b) { bfloat16 h; h.bits = b; return h; }
+    
+    /// conversion to float on load
+    operator float() const { return aux::bfloat16_bits_to_float(bits); }
+    
+    template <class S> bfloat16& operator+=(S const& s) { return *this = float(*this) + s; }
+    template <class S> bfloat16& operator-=(S const& s) { return *this = float(*this) - s; }
+    template <class S> bfloat16& operator*=(S const& s) { return *this = float(*this) * s; }
+    template <class S> bfloat16& operator/=(S const& s) { return *this = float(*this) / s; }
+  };
+  
+  
+  namespace traits
+  {
+    /// \cond HIDDEN_SYMBOLS
+    template <> struct compute_type_aux<half>     { typedef float type; };
+    template <> struct compute_type_aux<bfloat16> { typedef float type; };
+    /// \endcond
+    
+  } // end namespace traits
+  
+  
+  /// \brief the 16-bit storage types, with bulk conversion to and from float
+  template <class T>
+  concept bool Half_storage = std::is_same<T, half>::value || std::is_same<T, bfloat16>::value;
+  
+  
+  // ----- bulk conversion -----------------------------------------------------
+  
+  /// convert \p n values from half to float: dst[i] = src[i]
+  inline void convert(half const* src, float* dst, size_t n)
+  {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16)
+      _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(_mm256_loadu_si256((__m256i const*)(src + i))));
+#endif
+#if defined(__F16C__)
+    for (; i + 8 <= n; i += 8)
+      _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((__m128i const*)(src + i))));
+#endif
+    for (; i < n; ++i)
+      dst[i] = float(src[i]);
+  }
+  
+  /// convert \p n values from float to half, round to nearest even: dst[i] = src[i]
+  inline void convert(float const* src, half* dst, size_t n)
+  {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16)
+      _mm256_storeu_si256((__m256i*)(dst + i), 
+			  _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+#if defined(__F16C__)
+    for (; i + 8 <= n; i += 8)
+      _mm_storeu_si128((__m128i*)(dst + i), 
+		       _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+    for (; i < n; ++i)
+      dst[i] = half(src[i]);
+  }
+  
+  /// convert \p n values from bfloat16 to float: dst[i] = src[i]
+  inline void convert(bfloat16 const* src, float* dst, size_t n)
+  {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16) {
+      __m512i b = _mm512_cvtepu16_epi32(_mm256_loadu_si256((__m256i const*)(src + i)));
+      _mm512_storeu_ps(dst + i, _mm512_castsi512_ps(_mm512_slli_epi32(b, 16)));
+    }
+#endif
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8) {
+      __m256i b = _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i const*)(src + i)));
+      _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(b, 16)));
+    }
+#endif
+    for (; i < n; ++i)
+      dst[i] = float(src[i]);
+  }
+  
+  /// convert \p n values from float to bfloat16, round to nearest even: dst[i] = src[i]
+  inline void convert(float const* src, bfloat16* dst, size_t n)
+  {
+    size_t i = 0;
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+    for (; i + 16 <= n; i += 16)
+      _mm256_storeu_si256((__m256i*)(dst + i), (__m256i)_mm512_cvtneps_pbh(_mm512_loadu_ps(src + i)));
+#endif
+    for (; i < n; ++i)
+      dst[i] = bfloat16(src[i]);
+  }
+  
+  /// convert \p n values from a 16-bit type to double (via float)
+  template <Half_storage T>
+  void convert(T const* src, double* dst, size_t n)
+  {
+    const size_t block = 64;
+    float buffer[block];
+    for (size_t i = 0; i < n; i += block) {
+      size_t m = (n - i < block ? n - i : block);
+      convert(src + i, buffer, m);
+      for (size_t j = 0; j < m; ++j)
+	dst[i + j] = buffer[j];
+    }
+  }
+  
+  /// convert \p n values from double to a 16-bit type (via float)
+  template <Half_storage T>
+  void convert(double const* src, T* dst, size_t n)
+  {
+    const size_t block = 64;
+    float buffer[block];
+    for (size_t i = 0; i < n; i += block) {
+      size_t m = (n - i < block ? n - i : block);
+      for (size_t j = 0; j < m; ++j)
+	buffer[j] = float(src[i + j]);
+      convert(buffer, dst + i, m);
+    }
+  }
+  
+  
+  /// \brief a block of 16-bit values, converted to float by the bulk conversion.
+  /** Containers of 16-bit values are processed blockwise in the compute 
+   *  type: \ref load converts up to \ref capacity values to float, that are
+   *  accessed as expression with SIMD packets, and \ref store rounds them 
+   *  back. Used by the assignment to and the reductions of containers of 
+   *  half or bfloat16.
+   **/
+  template <Half_storage T>
+  struct ConvertedBlock
+  {
+    typedef traits::compute_type<T> value_type;
+    typedef size_t                   size_type;
+    
+    static constexpr int _SIZE = -1;
+    static constexpr int _ROWS = -1;
+    static constexpr int _COLS = -1;
+    
+    /// number of values in a block, e.g. 4KB of floats
+    static constexpr size_t capacity = 1024;
+    
+    /// data[i] = src[i], for i in [0, n), n <= capacity
+    void load(T const* src, size_t n) { convert(src, data, n); }
+    
+    /// dst[i] = data[i], for i in [0, n), n <= capacity
+    void store(T* dst, size_t n) const { convert(data, dst, n); }
+    
+    /// access the elements of the block
+    value_type& operator()(size_type i) { return data[i]; }
+    value_type const& operator()(size_type i) const { return data[i]; }
+    
+    /// access the elements [i, i+W) of the block as SIMD packet
+    template <int Bytes = SIMD_BYTES>
+    simd::Packet<value_type, Bytes> packet(size_type i) const { return simd::load<Bytes>(data + i); }
+    
+    ALIGNED(value_type, data, capacity);
+  };
+  
+  /// \brief processes the \p n values of \p src in blocks, converted to float.
+  /** Calls f(block, begin, m) for the blocks [begin, begin+m) of at most 
+   *  ConvertedBlock::capacity values.
+   **/
+  template <Half_storage T, class F>
+  inline void for_converted_blocks(T const* src, size_t n, F f)
+  {
+    ConvertedBlock<T> block;
+    for (size_t i = 0; i < n; i += ConvertedBlock<T>::capacity) {
+      size_t const m = std::min(n - i, ConvertedBlock<T>::capacity);
+      block.load(src + i, m);
+      f(block, i, m);
+    }
+  }
+  
+} // end namespace AMDiS
+
+
+namespace std
+{
+  /// \cond HIDDEN_SYMBOLS
+  template <>
+  class numeric_limits<AMDiS::half> : public numeric_limits<float>
+  {
+  public:
+    static constexpr int digits = 11;
+    static constexpr int digits10 = 3;
+    static constexpr int max_digits10 = 5;
+    static constexpr int max_exponent = 16;
+    static constexpr int min_exponent = -13;
+    static constexpr int max_exponent10 = 4;
+    static constexpr int min_exponent10 = -4;
+    static AMDiS::half min() { return AMDiS::half::from_bits(0x0400); }
+    static AMDiS::half lowest() { return AMDiS::half::from_bits(0xfbff); }
+    static AMDiS::half max() { return AMDiS::half::from_bits(0x7bff); }
+    static AMDiS::half epsilon() { return AMDiS::half::from_bits(0x1400); }
+    static AMDiS::half round_error() { return AMDiS::half::from_bits(0x3800); }
+    static AMDiS::half denorm_min() { return AMDiS::half::from_bits(0x0001); }
+    static AMDiS::half infinity() { return AMDiS::half::from_bits(0x7c00); }
+    static AMDiS::half quiet_NaN() { return AMDiS::half::from_bits(0x7e00); }
+    static AMDiS::half signaling_NaN() { return AMDiS::half::from_bits(0x7d00); }
+  };
+  
+  template <>
+  class numeric_limits<AMDiS::bfloat16> : public numeric_limits<float>
+  {
+  public:
+    static constexpr int digits = 8;
+    static constexpr int digits10 = 2;
+    static constexpr int max_digits10 = 4;
+    static AMDiS::bfloat16 min() { return AMDiS::bfloat16::from_bits(0x0080); }
+    static AMDiS::bfloat16 lowest() { return AMDiS::bfloat16::from_bits(0xff7f); }
+    static AMDiS::bfloat16 max() { return AMDiS::bfloat16::from_bits(0x7f7f); }
+    static AMDiS::bfloat16 epsilon() { return AMDiS::bfloat16::from_bits(0x3c00); }
+    static AMDiS::bfloat16 round_error() { return AMDiS::bfloat16::from_bits(0x3f00); }
+    static AMDiS::bfloat16 denorm_min() { return AMDiS::bfloat16::from_bits(0x0001); }
+    static AMDiS::bfloat16 infinity() { return AMDiS::bfloat16::from_bits(0x7f80); }
+    static AMDiS::bfloat16 quiet_NaN() { return AMDiS::bfloat16::from_bits(0x7fc0); }
+    static AMDiS::bfloat16 signaling_NaN() { return AMDiS::bfloat16::from_bits(0x7fa0); }
+  };
+  /// \endcond
+}
@@ -0,0 +1,169 @@
+/******************************************************************************
+ *
+ * AMDiS - Adaptive multidimensional simulations
+ *
+ * Copyright (C) 2013 Dresden University of Technology. All Rights Reserved.
+ * Web: https://fusionforge.zih.tu-dresden.de/projects/amdis
+ *
+ * Authors: 
+ * Simon Vey, Thomas Witkowski, Andreas Naumann, Simon Praetorius, et al.
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * This file is part of AMDiS
+ *
+ * See also license.opensource.txt in the distribution.
+ * 
+ ******************************************************************************/
+
+
+
+/** \file thread_pool.hpp */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Config.h"	// NUM_THREADS
+
+namespace AMDiS 
+{
+  /// \brief fixed pool of worker threads for the parallel loops of the library.
+  /** The pool is created at the first call of \ref instance, with NUM_THREADS
+   *  threads (default: one per hardware thread), including the calling 
+   *  thread. \ref parallel_for distributes tasks dynamically to the threads 
+   *  and returns when all tasks are done. Calls from inside a task, or while
+   *  another thread uses the pool, run serially in the calling thread, so 
+   *  that nested parallel loops can not deadlock.
+   **/
+  class ThreadPool
+  {
+  public:
+    /// the pool of the library, created at the first call
+    static ThreadPool& instance()
+    {
+      static ThreadPool pool(NUM_THREADS > 0 ? NUM_THREADS 
+					      : std::max(std::thread::hardware_concurrency(), 1u));
+      return pool;
+    }
+    
+    /// destructor, stops and joins all worker threads
+    ~ThreadPool()
+    {
+      {
+	std::lock_guard<std::mutex> lock(mutex);
+	stop = true;
+      }
+      wake.notify_all();
+      for (std::thread& worker : workers)
+	worker.join();
+    }
+    
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+    
+    /// number of threads, including the calling thread
+    size_t size() const { return workers.size() + 1; }
+    
+    /// call f(k) for all k in [0, n). The calling thread works on the tasks
+    /// as well. Returns when all tasks are done.
+    template <class F>
+    void parallel_for(size_t n, F const& f)
+    {
+      bool idle = false;
+      if (n <= 1 || workers.empty() || in_task() || !busy.compare_exchange_strong(idle, true)) {
+	for (size_t k = 0; k < n; ++k)
+	  f(k);
+	return;
+      }
+      
+      {
+	std::lock_guard<std::mutex> lock(mutex);
+	task = [&f](size_t k) { f(k); };
+	num_tasks = n;
+	next = 0;
+	active = workers.size();
+	++generation;
+      }
+      wake.notify_all();
+      run_tasks();
+      
+      {
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this]() { return active == 0; });
+	task = nullptr;
+      }
+      busy = false;
+    }
+    
+  private:
+    explicit ThreadPool(size_t num_threads)
+    {
+      workers.reserve(num_threads - 1);
+      for (size_t t = 1; t < num_threads; ++t)
+	workers.emplace_back([this]() { work(); });
+    }
+    
+    // true in threads that currently work on a task
+    static bool& in_task()
+    {
+      static thread_local bool flag = false;
+      return flag;
+    }
+    
+    // work on the tasks of the current loop, until all are taken
+    void run_tasks()
+    {
+      in_task() = true;
+      for (size_t k = next++; k < num_tasks; k = next++)
+	task(k);
+      in_task() = false;
+    }
+    
+    // main loop of the worker threads
+    void work()
+    {
+      unsigned long seen = 0;
+      for (;;) {
+	{
+	  std::unique_lock<std::mutex> lock(mutex);
+	  wake.wait(lock, [this, seen]() { return stop || generation != seen; });
+	  if (stop)
+	    return;
+	  seen = generation;
+	}
+	run_tasks();
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	if (--active == 0)
+	  done.notify_one();
+      }
+    }
+    
+  private:
+    std::vector<std::thread> workers;
+    
+    std::mutex mutex;
+    std::condition_variable wake;	// a new loop or stop
+    std::condition_variable done;	// all workers finished the loop
+    
+    std::function<void(size_t)> task;
+    size_t num_tasks = 0;
+    std::atomic<size_t> next{0};
+    size_t active = 0;			// workers still working on the loop
+    unsigned long generation = 0;	// number of the current loop
+    bool stop = false;
+    
+    std::atomic<bool> busy{false};	// the pool is used by a thread
+  };
+  
+} // end namespace AMDiS
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cstdlib>
 #include <vector>
+#include <limits>
 #include <cassert>
 #include <boost/numeric/conversion/cast.hpp> 
 
@@ -135,6 +136,41 @@ void test2(size_t s)
   staticVec = staticMat * staticVec;
   staticVec = mat * staticVec;
   
+  // no temporary needed, if target is not part of the expression
+  noalias(vec) = mat * staticVec;
+  noalias(staticVec) += staticMat * vec;
+  
+  // matrix-matrix product
+  mat = mat * staticMat;
+  staticMat = staticMat * staticMat;
+  mat += staticMat * mat;
+  vec = (mat * staticMat) * vec;
+  
+  // BLAS-1 shapes are mapped to fused expressions
+  vec = T(2) * staticVec + vec;
+  vec = T(2) * (T(3) * staticVec) - T(0.5) * vec;
+  staticVec += vec - T(2) * staticVec;
+  
+  // rank-1 updates without a temporary matrix, with distinct entries
+  Vector<T> pv(DOW);
+  StaticVector<T,DOW> qv(DOW);
+  for (size_t i = 0; i < DOW; ++i) {
+    pv[i] = T(i + 1) / T(3);
+    qv[i] = T(2) - T(0.7) * T(i);
+  }
+  Matrix<T> mat0(mat);
+  StaticMatrix<T,DOW,DOW> staticMat0(staticMat);
+  mat += T(2) * outer(pv, qv);
+  staticMat -= outer(qv, pv);
+  for (size_t i = 0; i < DOW; ++i) {
+    for (size_t j = 0; j < DOW; ++j) {
+      TEST_EXIT(mat(i,j) == mat0(i,j) + T(2) * pv(i) * qv(j))
+	("[outer] mat(" << i << "," << j << ") = " << mat(i,j) << "\n");
+      TEST_EXIT(staticMat(i,j) == staticMat0(i,j) - qv(i) * pv(j))
+	("[outer] staticMat(" << i << "," << j << ") = " << staticMat(i,j) << "\n");
+    }
+  }
+  
   // cross-product
   vec = cross(vec, vec);
   std::cout << "12) cross = " << max(vec) << "\n";
@@ -169,18 +205,642 @@ void test2(size_t s)
   std::cout << "21) " << min(vec) << "\n";
   std::cout << "22) " << abs_max(vec) << "\n";
   std::cout << "23) " << abs_min(vec) << "\n";
+  
+  // nonzero, mixed-sign data with distinct values: u < 0, 0 <= u <= 1 and u > 1
+  Vector<T> u(7);
+  for (size_t i = 0; i < size(u); ++i)
+    u[i] = T(0.75) * T(i) - T(2) + T(1) / T(i + 3);
+  T const tol = 16 * std::numeric_limits<T>::epsilon();
+  
+  // several reductions in one pass
+  T rs, rn, rmax, rmin;
+  std::tie(rs, rn, rmax, rmin) = reduce_all(u, functors::sum_reduction_functor<T>(), 
+					    functors::two_norm_functor<T>(), 
+					    functors::max_reduction_functor<T>(),
+					    functors::min_reduction_functor<T>());
+  std::cout << "24) " << rs << " " << rn << " " << rmax << " " << rmin << "\n";
+  TEST_EXIT(std::abs(rs - sum(u)) <= tol * one_norm(u))("[24] sum = " << rs << " != " << sum(u) << "\n");
+  TEST_EXIT(std::abs(rn - two_norm(u)) <= tol * rn)("[24] two_norm = " << rn << " != " << two_norm(u) << "\n");
+  TEST_EXIT(rmax == max(u) && rmax == u[6])("[24] max = " << rmax << " != " << max(u) << "\n");
+  TEST_EXIT(rmin == min(u) && rmin == u[0])("[24] min = " << rmin << " != " << min(u) << "\n");
+  
+  // negative values only: max() is not bounded by 0
+  Vector<T> neg(size(u));
+  for (size_t i = 0; i < size(u); ++i)
+    neg[i] = u[i] - T(3);
+  TEST_EXIT(max(neg) == neg[6] && std::get<0>(reduce_all(neg, functors::max_reduction_functor<T>())) == neg[6])
+    ("[24] max = " << max(neg) << " != " << neg[6] << "\n");
+  
+  // binary and unary functors in one pass, e.g. (r,r) and (r,z) of the CG method
+  Vector<T> z = T(2) * u;
+  T rr, rz;
+  std::tie(rr, rz) = reduce_all(u, z, functors::unary_dot_functor<T>(), functors::dot_functor<T,T>());
+  TEST_EXIT(std::abs(rr - dot(u, u)) <= tol * rr)("[24] (r,r) = " << rr << " != " << dot(u, u) << "\n");
+  TEST_EXIT(std::abs(rz - T(2) * rr) <= tol * rr)("[24] (r,z) = " << rz << " != " << T(2) * rr << "\n");
+  
+  // gather of element-local values, fused into the following operation,
+  // from the distinct values of u
+  StaticVector<int, 2> dofs{2, 0};
+  StaticVector<T, 2> local = indexed(u, dofs);
+  std::cout << "25) " << local << ", " << dot(indexed(u, dofs), local) << "\n";
+  TEST_EXIT(local[0] == u[2] && local[1] == u[0])("[25] local = " << local << "\n");
+  TEST_EXIT(std::abs(dot(indexed(u, dofs), local) - (u[2]*u[2] + u[0]*u[0])) 
+	    <= tol * (u[2]*u[2] + u[0]*u[0]))("[25] dot = " << dot(indexed(u, dofs), local) << "\n");
+  
+  // assembly of element contributions: vec[dofs[k]] += 2*local[k]
+  Vector<T> vec0(vec);
+  scatter_add(vec, dofs, T(2) * local);
+  scatter_add(vec, dofs, local, scatter::atomic());
+  for (size_t k = 0; k < 2; ++k) {
+    T expected = vec0[dofs[k]];
+    expected += T(2) * local[k];
+    expected += local[k];
+    vec0[dofs[k]] = expected;
+  }
+  for (size_t i = 0; i < size(vec); ++i)
+    TEST_EXIT(vec[i] == vec0[i])("[scatter] vec[" << i << "] = " << vec[i] << " != " << vec0[i] << "\n");
+  
+  // a repeated index accumulates all its contributions
+  StaticVector<int, 3> rep{1, 2, 1};
+  StaticVector<T, 3> contrib{u[3], u[4], u[5]};
+  vec0 = vec;
+  scatter_add(vec, rep, contrib);
+  scatter_add(vec, rep, contrib, scatter::atomic());
+  for (size_t i = 0; i < size(vec); ++i) {
+    T expected = vec0[i];
+    for (int r = 0; r < 2; ++r)
+      for (size_t k = 0; k < 3; ++k)
+	if (size_t(rep[k]) == i)
+	  expected += contrib[k];
+    TEST_EXIT(vec[i] == expected)("[scatter] repeated index: vec[" << i << "] = " << vec[i] << " != " << expected << "\n");
+  }
+  
+  // elementwise math functions, evaluated by SIMD packets and a scalar tail
+  Vector<T> x(11);
+  for (size_t i = 0; i < size(x); ++i)
+    x[i] = T(0.1) + T(1.37) * T(i);
+  Vector<T> w = exp(T(0.5) * log(pow(x, 2))) + sqrt(x);
+  std::cout << "26) " << w << "\n";
+  
+  // maximal error of 1 ulp for exp and log, 1 + 1.5*|y*log(x)| ulp for pow, 
+  // plus the rounding of the reference. sqrt is correctly rounded.
+  Vector<T> e = exp(x), l = log(x), p = pow(x, 2), r = sqrt(x);
+  T const eps = std::numeric_limits<T>::epsilon();
+  for (size_t i = 0; i < size(x); ++i) {
+    T const e0 = std::exp(x[i]), l0 = std::log(x[i]), p0 = std::pow(x[i], 2), r0 = std::sqrt(x[i]);
+    TEST_EXIT(std::abs(e[i] - e0) <= 2 * eps * e0)("[26] exp = " << e[i] << " != " << e0 << "\n");
+    TEST_EXIT(std::abs(l[i] - l0) <= 2 * eps * std::abs(l0))("[26] log = " << l[i] << " != " << l0 << "\n");
+    TEST_EXIT(std::abs(p[i] - p0) <= (2 + 3 * std::abs(l0)) * eps * p0)("[26] pow = " << p[i] << " != " << p0 << "\n");
+    TEST_EXIT(r[i] == r0)("[26] sqrt = " << r[i] << " != " << r0 << "\n");
+    
+    // exp(0.5*log(x^2)) = x: the error of log(x^2) is amplified by |log(x)|
+    T const w0 = std::exp(T(0.5) * std::log(std::pow(x[i], 2))) + r0;
+    TEST_EXIT(std::abs(w[i] - w0) <= (4 + 8 * std::abs(l0)) * eps * w0)("[26] w = " << w[i] << " != " << w0 << "\n");
+  }
+  
+  // branch-free selection with masks: clamp to [0, 1]
+  Vector<T> c = where(less(u, T(0)), T(0), where(greater(u, T(1)), T(1), u));
+  std::cout << "27) " << c << ", " << any(greater(c, T(1))) << all(greater_equal(c, T(0))) 
+	    << " " << count(equal_to(c, T(1))) << "\n";
+  size_t below = 0, above = 0;
+  for (size_t i = 0; i < size(u); ++i) {
+    T const c0 = u[i] < T(0) ? T(0) : (u[i] > T(1) ? T(1) : u[i]);
+    TEST_EXIT(c[i] == c0)("[27] c[" << i << "] = " << c[i] << " != " << c0 << "\n");
+    below += (u[i] < T(0));
+    above += (u[i] > T(1));
+  }
+  TEST_EXIT(below == 3 && above == 3)("[27] data: " << below << " values < 0, " << above << " values > 1\n");
+  TEST_EXIT(count(less(u, T(0))) == below && count(greater(u, T(1))) == above)
+    ("[27] count = " << count(less(u, T(0))) << ", " << count(greater(u, T(1))) << "\n");
+  TEST_EXIT(count(equal_to(c, T(0))) == below && count(equal_to(c, T(1))) == above)
+    ("[27] count = " << count(equal_to(c, T(0))) << ", " << count(equal_to(c, T(1))) << "\n");
+  TEST_EXIT(any(less(u, T(0))) && !all(less(u, T(0))) && any(greater(u, T(1))))("[27] any/all of u\n");
+  TEST_EXIT(!any(greater(c, T(1))) && !any(less(c, T(0))) && all(greater_equal(c, T(0))) && all(less_equal(c, T(1))))
+    ("[27] c not in [0, 1]\n");
+  
+  // blend of two vector expressions
+  Vector<T> b = where(greater(u, T(0)), u, T(-2) * u);
+  for (size_t i = 0; i < size(u); ++i)
+    TEST_EXIT(b[i] == (u[i] > T(0) ? u[i] : T(-2) * u[i]))("[27] b[" << i << "] = " << b[i] << "\n");
+  
+  // compile-time cost model, e.g. to compare measured GFLOP/s with the model
+  typedef decltype(T(0.5) * (vec + staticMat * vec)) expr_type;
+  traits::work_estimate work = traits::expected_work(T(0.5) * (vec + staticMat * vec));
+  std::cout << "28) flops/elem = " << traits::expr_cost<expr_type>::flops 
+	    << ", loads/elem = " << traits::expr_cost<expr_type>::loads
+	    << ", total: " << work.flops << " flops, " << work.bytes << " bytes\n";
+  
+  // compensated summation, selected per call
+  std::cout << "29) " << sum(u, tag::compensated()) << " " << dot(u, c, tag::compensated()) 
+	    << " " << two_norm(u, tag::compensated()) << "\n";
+  TEST_EXIT(std::abs(sum(u, tag::compensated()) - sum(u)) <= tol * one_norm(u))("[29] sum = " << sum(u, tag::compensated()) << "\n");
+  TEST_EXIT(std::abs(dot(u, c, tag::compensated()) - dot(u, c)) <= tol * std::abs(dot(u, c)))("[29] dot = " << dot(u, c, tag::compensated()) << "\n");
+  TEST_EXIT(std::abs(two_norm(u, tag::compensated()) - two_norm(u)) <= tol * two_norm(u))("[29] two_norm = " << two_norm(u, tag::compensated()) << "\n");
+  
+  // ill-conditioned sum: the naive summation loses the 1
+  Vector<T> v3(3);
+  v3[0] = T(1.e16); v3[1] = T(1); v3[2] = T(-1.e16);
+  TEST_EXIT(sum(v3, tag::compensated()) == T(1))("[29] = " << sum(v3, tag::compensated()) << "\n");
+  TEST_EXIT(std::get<0>(reduce_all(v3, functors::compensated_sum_functor<T>())) == T(1))
+    ("[29] = " << std::get<0>(reduce_all(v3, functors::compensated_sum_functor<T>())) << "\n");
+  
+  // closed-form determinant and inverse of small matrices
+  WorldMatrix<T> J(DOW, DOW, T(1));
+  for (size_t i = 0; i < DOW; ++i)
+    J(i, i) = T(2);
+  WorldMatrix<T> Jinv = inv(J, singular::check());
+  std::cout << "30) det = " << det(J) << ", inv = " << Jinv << "\n";
+  
+  // J = I + 1*1^T: det(J) = 1 + DOW, J^(-1) = I - 1*1^T / (1 + DOW)
+  TEST_EXIT(std::abs(det(J) - T(1 + DOW)) < 1.e-12)("[30] det = " << det(J) << "\n");
+  WorldMatrix<T> JJinv = J * Jinv;
+  for (size_t i = 0; i < DOW; ++i)
+    for (size_t j = 0; j < DOW; ++j)
+      TEST_EXIT(std::abs(JJinv(i, j) - T(i == j ? 1 : 0)) < 1.e-12)
+	("[30] (J*Jinv)(" << i << "," << j << ") = " << JJinv(i, j) << "\n");
+  
+  // batches: the Jacobians of several quadrature points, J_q = J + q*I
+  size_t const nq = 5;
+  Vector<WorldMatrix<T>> Js(nq, J);
+  for (size_t q = 0; q < nq; ++q)
+    for (size_t i = 0; i < DOW; ++i)
+      Js[q](i, i) += T(q);
+  Vector<T> dets = det(Js);
+  Vector<WorldMatrix<T>> Jinvs = inv(Js);
+  for (size_t q = 0; q < nq; ++q) {
+    // J_q = (1+q)*I + 1*1^T: det(J_q) = (1+q)^(DOW-1) * (1+q+DOW)
+    T const det_q = std::pow(T(1 + q), DOW - 1) * T(1 + q + DOW);
+    TEST_EXIT(std::abs(dets[q] - det_q) < 1.e-12 * det_q)("[30] det(J_" << q << ") = " << dets[q] << " != " << det_q << "\n");
+    TEST_EXIT(dets[q] == det(Js[q]))("[30] det(J_" << q << ") = " << dets[q] << " != " << det(Js[q]) << "\n");
+    WorldMatrix<T> Jq_inv = inv(Js[q]);
+    for (size_t i = 0; i < DOW; ++i)
+      for (size_t j = 0; j < DOW; ++j)
+	TEST_EXIT(Jinvs[q](i, j) == Jq_inv(i, j))
+	  ("[30] inv(J_" << q << ")(" << i << "," << j << ") = " << Jinvs[q](i, j) << "\n");
+  }
+  
+  // LU factorization with partial pivoting, reused for several right-hand sides
+  StaticMatrix<T,DOW,DOW> LU = J;
+  StaticVector<int,DOW> pivot;
+  lu(LU, pivot);
+  StaticVector<T,DOW> x1(DOW, T(1)), x2(DOW, T(2));
+  lu_solve(LU, pivot, x1);
+  lu_solve(LU, pivot, x2);
+  std::cout << "31) " << x1 << ", " << x2 << "\n";
+  
+  // J^(-1) * 1 = 1 / (1 + DOW)
+  for (size_t i = 0; i < DOW; ++i) {
+    TEST_EXIT(std::abs(x1(i) - T(1) / T(1 + DOW)) < 1.e-12)("[31] x1(" << i << ") = " << x1(i) << "\n");
+    TEST_EXIT(std::abs(x2(i) - T(2) / T(1 + DOW)) < 1.e-12)("[31] x2(" << i << ") = " << x2(i) << "\n");
+  }
+}
+
+
+// an expression with the nested temporaries (a+b) and 2*(a+b), that is 
+// evaluated after the function returned
+template <class T, class V>
+auto scaled_sum(V const& a, V const& b) -> decltype(T(2) * (a + b) - a)
+{
+  return T(2) * (a + b) - a;
+}
+
+template <class T, class M, class V>
+auto shifted_product(M const& A, V const& a, V const& b) -> decltype(A * (a - b))
+{
+  return A * (a - b);
 }
 
+// sub-expressions are stored by value and outlive the full expression
+template <class T>
+void test_temporaries()
+{
+  Vector<T> a(5), b(5), c(5);
+  for (size_t i = 0; i < size(a); ++i) {
+    a[i] = T(i) + T(1);
+    b[i] = T(2) * T(i) - T(3);
+    c[i] = T(10) - T(i);
+  }
+  Matrix<T> A(5, 5);
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = 0; j < 5; ++j)
+      A(i, j) = T(i + 1) - T(j);
+  
+  auto e1 = scaled_sum<T>(a, b);
+  auto e2 = scaled_sum<T>(a, c);	// reuses the stack frame of the first call
+  auto e3 = shifted_product<T>(A, a, c);
+  
+  Vector<T> r1 = e1, r2 = e2, r3 = e3;
+  for (size_t i = 0; i < size(a); ++i) {
+    TEST_EXIT(r1[i] == T(2) * (a[i] + b[i]) - a[i])("[32] r1[" << i << "] = " << r1[i] << "\n");
+    TEST_EXIT(r2[i] == T(2) * (a[i] + c[i]) - a[i])("[32] r2[" << i << "] = " << r2[i] << "\n");
+    T r0 = 0;
+    for (size_t j = 0; j < 5; ++j)
+      r0 += A(i, j) * (a[j] - c[j]);
+    TEST_EXIT(r3[i] == r0)("[32] r3[" << i << "] = " << r3[i] << " != " << r0 << "\n");
+  }
+}
+
+// C = A*B by the textbook triple loop
+template <class T, class MA, class MB>
+Matrix<T> naive_product(MA const& A, MB const& B)
+{
+  Matrix<T> C(num_rows(A), num_cols(B));
+  for (size_t i = 0; i < num_rows(A); ++i)
+    for (size_t j = 0; j < num_cols(B); ++j) {
+      T c = 0;
+      for (size_t k = 0; k < num_cols(A); ++k)
+	c += A(i, k) * B(k, j);
+      C(i, j) = c;
+    }
+  return C;
+}
+
+// small integer values: all products and sums are exact
+template <class M>
+void fill_matrix(M& A, int seed)
+{
+  for (size_t i = 0; i < num_rows(A); ++i)
+    for (size_t j = 0; j < num_cols(A); ++j)
+      A(i, j) = int(3 * i + 7 * j + seed) % 11 - 5;
+}
+
+template <class M1, class M2>
+bool equal_entries(M1 const& A, M2 const& B)
+{
+  bool equal = num_rows(A) == num_rows(B) && num_cols(A) == num_cols(B);
+  for (size_t i = 0; equal && i < num_rows(A); ++i)
+    for (size_t j = 0; equal && j < num_cols(A); ++j)
+      equal = A(i, j) == B(i, j);
+  return equal;
+}
+
+// matrix-matrix products against the triple loop
+template <class T>
+void test_products()
+{
+  // static sizes, that are no multiples of the register tiles
+  StaticMatrix<T,7,5> A(7, 5);
+  StaticMatrix<T,5,6> B(5, 6);
+  fill_matrix(A, 1);
+  fill_matrix(B, 2);
+  StaticMatrix<T,7,6> C = A * B;
+  TEST_EXIT(equal_entries(C, naive_product<T>(A, B)))("[33] static A*B = " << C << "\n");
+  
+  // dynamic sizes larger than the cache blocks
+  Matrix<T> D(37, 45), E(45, 41);
+  fill_matrix(D, 3);
+  fill_matrix(E, 4);
+  Matrix<T> F = D * E;
+  TEST_EXIT(equal_entries(F, naive_product<T>(D, E)))("[33] dynamic D*E\n");
+  F += D * E;
+  TEST_EXIT(equal_entries(F, T(2) * naive_product<T>(D, E)))("[33] dynamic F += D*E\n");
+  
+  // the target is an argument of the product
+  StaticMatrix<T,7,7> G(7, 7), H(7, 7);
+  fill_matrix(G, 5);
+  fill_matrix(H, 6);
+  Matrix<T> G0 = naive_product<T>(G, H);
+  G = G * H;
+  TEST_EXIT(equal_entries(G, G0))("[33] static G = G*H: " << G << "\n");
+  
+  Matrix<T> K(37, 37), L(37, 37);
+  fill_matrix(K, 7);
+  fill_matrix(L, 8);
+  Matrix<T> K0 = naive_product<T>(K, L);
+  K = K * L;
+  TEST_EXIT(equal_entries(K, K0))("[33] dynamic K = K*L\n");
+}
+
+// the target is part of the expression: same result as with an explicit copy
+template <class T>
+void test_aliasing()
+{
+  Matrix<T> A(DOW, DOW);
+  fill_matrix(A, 1);
+  Vector<T> v(DOW), w(DOW);
+  for (size_t i = 0; i < DOW; ++i) {
+    v[i] = T(i) + T(2);
+    w[i] = T(1) - T(3) * T(i);
+  }
+  
+  Vector<T> v0(v);
+  Vector<T> r0 = A * v0;
+  v = A * v;
+  for (size_t i = 0; i < DOW; ++i)
+    TEST_EXIT(v[i] == r0[i])("[34] v = A*v: v[" << i << "] = " << v[i] << " != " << r0[i] << "\n");
+  
+  v0 = v;
+  r0 = cross(v0, w);
+  v = cross(v, w);
+  for (size_t i = 0; i < DOW; ++i)
+    TEST_EXIT(v[i] == r0[i])("[34] v = cross(v,w): v[" << i << "] = " << v[i] << " != " << r0[i] << "\n");
+  
+  r0 = cross(w, v0);
+  v = v0;
+  v = cross(w, v);
+  for (size_t i = 0; i < DOW; ++i)
+    TEST_EXIT(v[i] == r0[i])("[34] v = cross(w,v): v[" << i << "] = " << v[i] << " != " << r0[i] << "\n");
+  
+  // noalias: no temporary, same result if the target is not part of the expression
+  Vector<T> x(DOW), y(DOW);
+  x = A * w + T(2) * v;
+  noalias(y) = A * w + T(2) * v;
+  for (size_t i = 0; i < DOW; ++i)
+    TEST_EXIT(x[i] == y[i])("[34] noalias: y[" << i << "] = " << y[i] << " != " << x[i] << "\n");
+  
+  x += A * v;
+  noalias(y) += A * v;
+  for (size_t i = 0; i < DOW; ++i)
+    TEST_EXIT(x[i] == y[i])("[34] noalias: y[" << i << "] = " << y[i] << " != " << x[i] << "\n");
+}
+
+// hybrid containers: every runtime size up to the capacity has its own
+// unrolled kernel. The size of FixVec<T,PARTS> and FixMat<T,PARTS> is dim+1.
+template <class T>
+void test_hybrid()
+{
+  for (size_t dim = 0; dim < size_t(MaxSize<PARTS>::value); ++dim) {
+    FixVec<T, PARTS> a(dim), b(dim), c(dim);
+    size_t const n = size(a);
+    TEST_EXIT(n == dim + 1)("[35] dim = " << dim << ": size = " << n << "\n");
+    for (size_t i = 0; i < n; ++i) {
+      b[i] = T(i) + T(1);
+      c[i] = T(2) - T(i) * T(i);
+    }
+    a = b + T(2) * c;
+    for (size_t i = 0; i < n; ++i)
+      TEST_EXIT(a[i] == b[i] + T(2) * c[i])("[35] n = " << n << ": a[" << i << "] = " << a[i] << "\n");
+    a -= c;
+    for (size_t i = 0; i < n; ++i)
+      TEST_EXIT(a[i] == b[i] + c[i])("[35] n = " << n << ": a[" << i << "] = " << a[i] << "\n");
+    a = T(3);
+    TEST_EXIT(sum(a) == T(3 * n))("[35] n = " << n << ": sum = " << sum(a) << "\n");
+    
+    FixMat<T, PARTS> A(dim, dim), B(dim, dim);
+    TEST_EXIT(num_rows(A) == n && num_cols(A) == n)("[35] dim = " << dim << ": " << num_rows(A) << "x" << num_cols(A) << "\n");
+    fill_matrix(B, int(n));
+    A = T(2) * B;
+    A += B;
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+	TEST_EXIT(A(i, j) == T(3) * B(i, j))("[35] n = " << n << ": A(" << i << "," << j << ") = " << A(i, j) << "\n");
+  }
+}
+
+// static-size reductions are evaluated as balanced trees: compare with 
+// sequential loops for odd sizes, i.e. unpaired leaves in the tree
+template <class T, int N>
+void test_tree_reduction()
+{
+  StaticVector<T, N> a(N), b(N);
+  for (int i = 0; i < N; ++i) {
+    a[i] = T((5 * i + 3) % 7) - T(3);	// small integers: sums are exact
+    b[i] = T(1) - T(i % 3);
+  }
+  T s0 = 0, d0 = 0, n0 = 0, max0 = a[0], min0 = a[0];
+  for (int i = 0; i < N; ++i) {
+    s0 += a[i];
+    d0 += a[i] * b[i];
+    n0 += a[i] * a[i];
+    max0 = std::max(max0, a[i]);
+    min0 = std::min(min0, a[i]);
+  }
+  TEST_EXIT(sum(a) == s0)("[36] N = " << N << ": sum = " << sum(a) << " != " << s0 << "\n");
+  TEST_EXIT(dot(a, b) == d0)("[36] N = " << N << ": dot = " << dot(a, b) << " != " << d0 << "\n");
+  TEST_EXIT(unary_dot(a) == n0)("[36] N = " << N << ": unary_dot = " << unary_dot(a) << " != " << n0 << "\n");
+  TEST_EXIT(std::abs(two_norm(a) - std::sqrt(n0)) <= 4 * std::numeric_limits<T>::epsilon() * std::sqrt(n0))
+    ("[36] N = " << N << ": two_norm = " << two_norm(a) << "\n");
+  TEST_EXIT(max(a) == max0 && min(a) == min0)("[36] N = " << N << ": max/min = " << max(a) << " " << min(a) << "\n");
+  TEST_EXIT(sum(a + b) == s0 + sum(b))("[36] N = " << N << ": sum(a+b) = " << sum(a + b) << "\n");
+}
+
+// dynamic-size reductions with several accumulators and a scalar tail, 
+// for sizes that are no multiples of the number of accumulators
+template <class T>
+void test_blocked_reduction()
+{
+  for (size_t n : {1, 3, 7, 13, 31, 67, 1021}) {
+    Vector<T> a(n), b(n);
+    for (size_t i = 0; i < n; ++i) {
+      a[i] = T(int(5 * i + 3) % 7) - T(3);	// small integers: sums are exact
+      b[i] = T(1) - T(i % 3);
+    }
+    a[n - 1] = T(-7);	// extreme values in the tail
+    
+    T s0 = 0, d0 = 0, n0 = 0, o0 = 0, max0 = a[0], min0 = a[0];
+    for (size_t i = 0; i < n; ++i) {
+      s0 += a[i];
+      d0 += a[i] * b[i];
+      n0 += a[i] * a[i];
+      o0 += std::abs(a[i]);
+      max0 = std::max(max0, a[i]);
+      min0 = std::min(min0, a[i]);
+    }
+    TEST_EXIT(sum(a) == s0)("[37] n = " << n << ": sum = " << sum(a) << " != " << s0 << "\n");
+    TEST_EXIT(dot(a, b) == d0)("[37] n = " << n << ": dot = " << dot(a, b) << " != " << d0 << "\n");
+    TEST_EXIT(unary_dot(a) == n0)("[37] n = " << n << ": unary_dot = " << unary_dot(a) << " != " << n0 << "\n");
+    TEST_EXIT(one_norm(a) == o0)("[37] n = " << n << ": one_norm = " << one_norm(a) << " != " << o0 << "\n");
+    TEST_EXIT(max(a) == max0 && min(a) == min0 && min0 == T(-7))
+      ("[37] n = " << n << ": max/min = " << max(a) << " " << min(a) << "\n");
+    TEST_EXIT(sum(a - b) == s0 - sum(b))("[37] n = " << n << ": sum(a-b) = " << sum(a - b) << "\n");
+  }
+}
+
+// functor, that counts its evaluations
+template <class T>
+struct counted_twice : FunctorBase
+{
+  typedef T result_type;
+  typedef T value_type;
+  
+  static size_t calls;
+  
+  static result_type apply(const T& a) { ++calls; return T(2) * a; }
+  result_type operator()(const T& a) const { return apply(a); }
+};
+
+template <class T>
+size_t counted_twice<T>::calls = 0;
+
+// cross(a, b) reads each element of its arguments twice: costly arguments
+// are evaluated only once per element on assignment
+template <class T>
+void test_cross_evaluation()
+{
+  Vector<T> a(DOW), b(DOW), c(DOW);
+  for (size_t i = 0; i < DOW; ++i) {
+    a[i] = T(i) + T(1);
+    b[i] = T(2) - T(3) * T(i);
+  }
+  ElementwiseUnaryExpr<Vector<T>, counted_twice<T>> a2(a);
+  
+  counted_twice<T>::calls = 0;
+  c = cross(a2, b - a);
+  TEST_EXIT(counted_twice<T>::calls == DOW)("[38] " << counted_twice<T>::calls << " evaluations of 2*a\n");
+  
+  Vector<T> a0 = T(2) * a, d0 = b - a;
+  Vector<T> c0 = cross(a0, d0);
+  for (size_t i = 0; i < DOW; ++i)
+    TEST_EXIT(c[i] == c0[i])("[38] c[" << i << "] = " << c[i] << " != " << c0[i] << "\n");
+}
+
+// the rewrite rules for BLAS-1 shapes give the values of the unfused 
+// expressions, in the packets and in the scalar tail
+template <class T>
+void test_blas1()
+{
+  size_t const n = 37;
+  Vector<T> x(n), y(n), r(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = T(1) / T(i + 3);
+    y[i] = T(0.7) * T(i) - T(5);
+  }
+  T const a = T(0.3), b = T(-1.7);
+  
+  r = a * x + y;
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(r[i] == a * x[i] + y[i])("[39] a*x+y: r[" << i << "] = " << r[i] << "\n");
+  r = x + a * y;
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(r[i] == x[i] + a * y[i])("[39] x+a*y: r[" << i << "] = " << r[i] << "\n");
+  r = a * x + b * y;
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(r[i] == a * x[i] + b * y[i])("[39] a*x+b*y: r[" << i << "] = " << r[i] << "\n");
+  r = x - a * y;
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(r[i] == x[i] - a * y[i])("[39] x-a*y: r[" << i << "] = " << r[i] << "\n");
+  
+  r = T(2) * (T(3) * x);
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(r[i] == T(2) * (T(3) * x[i]))("[39] 2*(3*x): r[" << i << "] = " << r[i] << "\n");
+  r = -(-x);
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(r[i] == x[i])("[39] -(-x): r[" << i << "] = " << r[i] << "\n");
+  
+  r = y;
+  r -= a * x;
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(r[i] == y[i] - a * x[i])("[39] r -= a*x: r[" << i << "] = " << r[i] << "\n");
+}
+
+// packet(i) returns the elements [i, i+W) of operator(), and the assignment
+// by packets and a scalar tail gives the values of operator()
+template <class E>
+bool packets_agree(E const& expr)
+{
+  typedef Value_type<E> T;
+  static_assert(simd::Packet_access<E, T>, "no packet access");
+  
+  size_t const W = simd::packet_traits<T>::size;
+  Vector<T> r = expr;
+  bool agree = true;
+  for (size_t i = 0; i + W <= size(expr); i += W) {
+    simd::Packet<T> const p = expr.packet(i);
+    for (size_t k = 0; k < W; ++k)
+      agree = agree && p[k] == expr(i + k);
+  }
+  for (size_t i = 0; i < size(expr); ++i)
+    agree = agree && r[i] == expr(i);
+  return agree;
+}
+
+template <class T>
+void test_packets()
+{
+  size_t const n = 4 * simd::packet_traits<T>::size + 3;	// with a scalar tail
+  Vector<T> x(n), y(n);
+  Vector<int> idx(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = T(0.25) * T(i) - T(2);
+    y[i] = T(1) / T(i + 1);
+    idx[i] = int((7 * i + 2) % n);
+  }
+  
+  TEST_EXIT(packets_agree(x))("[40] x\n");
+  TEST_EXIT(packets_agree(x + y) && packets_agree(x - y) && packets_agree((x + y) - x))("[40] elementwise binary\n");
+  TEST_EXIT(packets_agree(-x) && packets_agree(exp(y)) && packets_agree(sqrt(y)))("[40] elementwise unary\n");
+  TEST_EXIT(packets_agree(T(3) * x) && packets_agree(x / T(3)))("[40] scale\n");
+  TEST_EXIT(packets_agree(T(3) * x + y) && packets_agree(x - T(0.5) * y))("[40] axpby\n");
+  TEST_EXIT(packets_agree(where(less(x, T(0)), y, x)) && packets_agree(where(greater(x, y), x, T(1))))("[40] where\n");
+  TEST_EXIT(packets_agree(indexed(x, idx)) && packets_agree(indexed(x, idx) * T(2) + y))("[40] indexed\n");
+}
+
+// the dispatched kernels with packets of 16, 32 and 64 bytes: the elementwise
+// assignment is identical, the reductions agree up to the order of summation
+template <class T>
+void test_kernel_widths()
+{
+  using simd::aux::kernels;
+  TEST_EXIT(simd::isa_bytes<simd::Isa::sse2>::value == SIMD_BYTES)("[41] width of the baseline kernels\n");
+#if REPRODUCIBLE_SIMD
+  TEST_EXIT(simd::isa_bytes<simd::Isa::avx2>::value == SIMD_BYTES && 
+	    simd::isa_bytes<simd::Isa::avx512>::value == SIMD_BYTES)("[41] reproducible widths\n");
+#endif
+  
+  size_t const n = 67;	// with a scalar tail for all widths
+  Vector<T> x(n), y(n), r16(n), r32(n), r64(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = T(1) / T(i + 3);
+    y[i] = T(0.7) * T(i) - T(5);
+  }
+  
+  auto const expr = T(0.3) * y + sqrt(x);
+  kernels<16>::assign(r16.data(), expr, n, mtl::assign::assign_sum());
+  kernels<32>::assign(r32.data(), expr, n, mtl::assign::assign_sum());
+  kernels<64>::assign(r64.data(), expr, n, mtl::assign::assign_sum());
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(r16[i] == expr(i) && r32[i] == expr(i) && r64[i] == expr(i))
+      ("[41] assign: r[" << i << "] = " << r16[i] << ", " << r32[i] << ", " << r64[i] << "\n");
+  
+  typedef functors::one_norm_functor<T> Norm;
+  T n16, n32, n64;
+  kernels<16>::accumulate(x, n, n16, Norm());
+  kernels<32>::accumulate(x, n, n32, Norm());
+  kernels<64>::accumulate(x, n, n64, Norm());
+  T const tol = T(100) * std::numeric_limits<T>::epsilon() * n16;
+  TEST_EXIT(std::abs(n32 - n16) <= tol && std::abs(n64 - n16) <= tol)
+    ("[41] accumulate: " << n16 << ", " << n32 << ", " << n64 << "\n");
+  
+  typedef functors::dot_functor<T, T> Dot;
+  T d16, d32, d64;
+  kernels<16>::inner_product(x, y, n, d16, Dot());
+  kernels<32>::inner_product(x, y, n, d32, Dot());
+  kernels<64>::inner_product(x, y, n, d64, Dot());
+  T const dtol = T(100) * std::numeric_limits<T>::epsilon() * (one_norm(x) * abs_max(y));
+  TEST_EXIT(std::abs(d32 - d16) <= dtol && std::abs(d64 - d16) <= dtol)
+    ("[41] inner_product: " << d16 << ", " << d32 << ", " << d64 << "\n");
+}
 
 int main(int argc, char** argv)
 {
   test1<double>(10);
   test1<int>(10);
   test2<double>(10);
+  test_temporaries<double>();
+  test_products<double>();
+  test_aliasing<double>();
+  test_hybrid<double>();
+  test_tree_reduction<double, 1>();
+  test_tree_reduction<double, 3>();
+  test_tree_reduction<double, 5>();
+  test_tree_reduction<double, 7>();
+  test_tree_reduction<double, 13>();
+  test_blocked_reduction<double>();
+  test_cross_evaluation<double>();
+  test_blas1<double>();
+  test_packets<double>();
+  test_packets<float>();
+  test_kernel_widths<double>();
+  test_kernel_widths<float>();
   //test2<int>(10);
   
   functors::root<8, double> F0;
   functors::root<9, double> F1;
   
+  // static containers and elementwise expressions in constant expressions
+  static constexpr StaticVector<double, 3> e0{1.0, 0.0, 0.0};
+  static constexpr StaticVector<double, 3> e1{0.0, 1.0, 0.0};
+  static_assert(sum(e0 + e1) == 2.0 && max(e0 - e1) == 1.0, "constexpr evaluation");
+  
   return 0;
 }
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+
+#include "AMDiS.h"
+
+using namespace AMDiS;
+
+// containers of 16-bit values, with arithmetics in float
+template <class T>
+void test_storage(size_t n)
+{
+  Vector<T> a(n), b(n), c(n);
+  Vector<float> af(n), bf(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = std::sin(float(i));
+    b[i] = T(i % 7) - T(3);
+    af[i] = a[i];
+    bf[i] = b[i];
+  }
+
+  // assignment: computed in float, rounded once on store
+  c = a + b;
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(c[i].bits == T(af[i] + bf[i]).bits)("[assign] c[" << i << "] = " << float(c[i]) << "\n");
+
+  c += a;
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(c[i].bits == T(float(T(af[i] + bf[i])) + af[i]).bits)("[update] c[" << i << "] = " << float(c[i]) << "\n");
+
+  // the other compound assignments load the old values blockwise, in blocks 
+  // of ConvertedBlock::capacity values and a tail
+  Vector<T> v(c), w(n);
+  for (size_t i = 0; i < n; ++i)
+    w[i] = T(1 + i % 5);
+  c -= b;
+  v *= a;
+  for (size_t i = 0; i < n; ++i) {
+    float const c0 = float(T(float(T(af[i] + bf[i])) + af[i]));
+    TEST_EXIT(c[i].bits == T(c0 - bf[i]).bits)("[update] c[" << i << "] = " << float(c[i]) << "\n");
+    TEST_EXIT(v[i].bits == T(c0 * af[i]).bits)("[update] v[" << i << "] = " << float(v[i]) << "\n");
+  }
+  
+  v = c;
+  c /= w;
+  v = v + a;
+  for (size_t i = 0; i < n; ++i) {
+    float const c0 = float(T(float(T(float(T(af[i] + bf[i])) + af[i])) - bf[i]));
+    TEST_EXIT(c[i].bits == T(c0 / float(w[i])).bits)("[update] c[" << i << "] = " << float(c[i]) << "\n");
+    TEST_EXIT(v[i].bits == T(c0 + af[i]).bits)("[alias] v[" << i << "] = " << float(v[i]) << "\n");
+  }
+  
+  // reductions: accumulated in float
+  double s = 0, d = 0;
+  for (size_t i = 0; i < n; ++i) {
+    s += af[i];
+    d += double(af[i]) * bf[i];
+  }
+  TEST_EXIT(std::abs(sum(a) - s) <= 1.e-6 * n)("[sum] " << sum(a) << " != " << s << "\n");
+  TEST_EXIT(std::abs(dot(a, b) - d) <= 1.e-6 * n)("[dot] " << dot(a, b) << " != " << d << "\n");
+}
+
+int main(int argc, char** argv)
+{
+  static_assert(sizeof(half) == 2 && sizeof(bfloat16) == 2, "16-bit storage");
+
+  typedef std::numeric_limits<half> limits;
+  TEST_EXIT(float(limits::epsilon()) == std::ldexp(1.0f, -10))("[limits] epsilon\n");
+  TEST_EXIT(float(limits::denorm_min()) == std::ldexp(1.0f, -24))("[limits] denorm_min\n");
+  TEST_EXIT(float(limits::round_error()) == 0.5f)("[limits] round_error\n");
+  TEST_EXIT(float(std::numeric_limits<bfloat16>::denorm_min()) == std::ldexp(1.0f, -133))("[limits] denorm_min\n");
+
+  // conversion from all arithmetic types
+  TEST_EXIT(float(half(3L)) == 3.0f && float(half(7u)) == 7.0f && float(bfloat16(5ul)) == 5.0f)
+    ("[conversion] integer types\n");
+
+  for (size_t n : {1000, 100003}) {
+    test_storage<half>(n);
+    test_storage<bfloat16>(n);
+  }
+
+  std::cout << "16-bit storage results agree\n";
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+// small thresholds, so that the thread pool is used for moderate sizes
+#define NUM_THREADS           4
+#define PARALLEL_MIN_WORK     1000
+#define REDUCTION_CHUNK_SIZE  1024
+
+#include "AMDiS.h"
+
+using namespace AMDiS;
+
+// evaluate f() serially: parallel loops inside a task of the pool run in
+// the calling thread
+template <class F>
+void serial(F const& f)
+{
+  ThreadPool::instance().parallel_for(2, [&f](size_t k) { if (k == 0) f(); });
+}
+
+// threaded assignment of large vectors
+template <class T>
+void test_assign(size_t n)
+{
+  Vector<T> a(n), b(n), c(n), ref(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = T(i % 17) - T(8);
+    b[i] = T(1) / T(i + 1);
+  }
+
+  c = T(2) * a + b;
+  serial([&]() { ref = T(2) * a + b; });
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(c[i] == ref[i])("[assign] c[" << i << "] = " << c[i] << " != " << ref[i] << "\n");
+
+  c += a;
+  serial([&]() { ref += a; });
+  for (size_t i = 0; i < n; ++i)
+    TEST_EXIT(c[i] == ref[i])("[update] c[" << i << "] = " << c[i] << " != " << ref[i] << "\n");
+}
+
+// chunked reductions give bit-identical results for any number of threads
+template <class T>
+void test_reduce(size_t n)
+{
+  Vector<T> a(n), b(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = std::sin(T(i));
+    b[i] = T(1) / T(i + 1);
+  }
+
+  T s = sum(a), d = dot(a, b), nrm = two_norm(a), m = max(a);
+  T s1 = 0, d1 = 0, nrm1 = 0, m1 = 0;
+  serial([&]() { s1 = sum(a); d1 = dot(a, b); nrm1 = two_norm(a); m1 = max(a); });
+
+  TEST_EXIT(s == s1)("[sum] " << s << " != " << s1 << "\n");
+  TEST_EXIT(d == d1)("[dot] " << d << " != " << d1 << "\n");
+  TEST_EXIT(nrm == nrm1)("[two_norm] " << nrm << " != " << nrm1 << "\n");
+  TEST_EXIT(m == m1)("[max] " << m << " != " << m1 << "\n");
+
+  // same result as the sequential sum, up to rounding
+  T ref = 0;
+  for (size_t i = 0; i < n; ++i)
+    ref += a[i];
+  TEST_EXIT(std::abs(s - ref) <= 1.e-12 * n)("[sum] " << s << " != " << ref << "\n");
+}
+
+// elements, that do not partition a cache line, are assigned serially
+void test_elements(size_t n)
+{
+  typedef StaticVector<double, 3> V;
+  Vector<V> a(n), b(n);
+  for (size_t i = 0; i < n; ++i)
+    a[i] = V(3, double(i));
+  
+  b = a;
+  b += a;
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < 3; ++j)
+      TEST_EXIT(b[i][j] == 2.0 * i)("[elements] b[" << i << "][" << j << "] = " << b[i][j] << "\n");
+}
+
+// element-local contributions with small integer values, i.e. the sums are
+// exact in any order of the updates
+inline StaticVector<double, 3> element_contribution(size_t e)
+{
+  return {double(e % 5 + 1), double(e % 3 + 1), double(e % 7 + 1)};
+}
+
+// assembly by NUM_THREADS threads gives the result of the serial assembly
+void test_assemble(size_t n)
+{
+  // elements with 3 of m global indices: all threads write to the same entries
+  size_t const m = 64;
+  auto dofs = [m](size_t e) { return StaticVector<int, 3>{int(e % m), int((e + 1) % m), int((7 * e) % m)}; };
+  
+  Vector<double> ref(m, 0.0), glob(m, 0.0);
+  assemble(n, [&](size_t e, auto mode) { scatter_add(ref, dofs(e), element_contribution(e), mode); }, 
+	   scatter::serial());
+  assemble(n, [&](size_t e, auto mode) { scatter_add(glob, dofs(e), element_contribution(e), mode); }, 
+	   scatter::atomic(), NUM_THREADS);
+  for (size_t i = 0; i < m; ++i)
+    TEST_EXIT(glob[i] == ref[i])("[assemble] atomic: glob[" << i << "] = " << glob[i] << " != " << ref[i] << "\n");
+  
+  // a chain of elements {e, e+1}, coloured by even and odd elements
+  auto edge = [](size_t e) { return StaticVector<int, 2>{int(e), int(e + 1)}; };
+  auto contrib = [](size_t e) { return StaticVector<double, 2>{element_contribution(e)[0], element_contribution(e)[1]}; };
+  std::vector<std::vector<size_t>> colours(2);
+  for (size_t e = 0; e < n; ++e)
+    colours[e % 2].push_back(e);
+  
+  Vector<double> ref2(n + 1, 0.0), glob2(n + 1, 0.0);
+  assemble(n, [&](size_t e, auto mode) { scatter_add(ref2, edge(e), contrib(e), mode); }, scatter::serial());
+  assemble(colours, [&](size_t e, auto mode) { scatter_add(glob2, edge(e), contrib(e), mode); }, 
+	   scatter::coloured(), NUM_THREADS);
+  for (size_t i = 0; i <= n; ++i)
+    TEST_EXIT(glob2[i] == ref2[i])("[assemble] coloured: glob[" << i << "] = " << glob2[i] << " != " << ref2[i] << "\n");
+}
+
+int main(int argc, char** argv)
+{
+  TEST_EXIT(ThreadPool::instance().size() == NUM_THREADS)("pool size = " << ThreadPool::instance().size() << "\n");
+
+  for (size_t n : {1000, 100003, 1000000}) {
+    test_assign<double>(n);
+    test_reduce<double>(n);
+  }
+  test_assign<float>(100003);
+  test_elements(100003);
+  test_assemble(1000000);
+
+  std::cout << "threaded and serial results agree\n";
+  return 0;
+}